@@ -0,0 +1,86 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "Bench/PerfCounters.hpp"
+
+/* -------------------------------------------------------------------------- */
+/*                              Engine benchmarks                             */
+/* -------------------------------------------------------------------------- */
+
+struct BenchOptions {
+  size_t events = 1000000;  // requests per repetition (split across producers)
+  int warmup = 1;           // untimed repetitions before measuring
+  int reps = 5;
+  std::vector<int> producers{1, 2, 4};  // multi-producer scaling points
+
+  // open-loop offered load, as fractions of the measured capacity
+  std::vector<double> loads{0.1, 0.2, 0.3, 0.4, 0.5, 0.6, 0.7, 0.8, 0.9, 1.0, 1.1, 1.2};
+  double capacity = 0;  // requests/sec; 0 = measure closed-loop first
+
+  // hardware counters on the matching thread (not for open-loop, whose
+  // matching thread mostly spins idle)
+  bool perf = false;
+};
+
+// One scenario at one producer count, aggregated over all repetitions
+struct BenchResult {
+  std::string scenario;
+  int producers = 1;
+  double load = 0;        // open loop: offered fraction of capacity (0 = closed loop)
+  size_t ops = 0;         // requests per repetition
+  int reps = 0;
+  double opsPerSec = 0;   // median over repetitions
+  double p50Ns = 0;       // per-request latency, pooled over repetitions
+  double p99Ns = 0;
+  double p999Ns = 0;
+
+  // Per request, indexed by PerfEvent and summed over repetitions;
+  // -1 where the counter was not captured
+  std::array<double, PerfCounters::kEvents> perfPerOp{-1, -1, -1, -1, -1, -1};
+};
+
+// Single-producer scenarios replay their flow through an inline book and
+// time every request end to end (matching included). Threaded scenarios
+// time each submitRequest from the producer side and measure throughput
+// up to the drained book. The open-loop scenario sends on a fixed
+// schedule instead and measures from each request's intended send time
+// to the end of its matching, so queueing delay is not hidden by a
+// producer that stalls (coordinated omission).
+struct BenchScenario {
+  const char* name;
+  const char* description;
+  std::vector<BenchResult> (*run)(const BenchScenario& scenario,
+                                  const BenchOptions& options);
+};
+
+const std::vector<BenchScenario>& benchScenarios();
+
+// nullptr if there is no scenario called `name`
+const BenchScenario* findBenchScenario(const std::string& name);
+
+void writeJson(std::ostream& out, const std::vector<BenchResult>& results);
+void writeCsv(std::ostream& out, const std::vector<BenchResult>& results);
+
+// Reads what writeCsv() wrote; used for baselines
+std::vector<BenchResult> readCsv(std::istream& in);
+
+struct BenchRegression {
+  std::string scenario;
+  int producers;
+  double load;
+  std::string metric;
+  double baseline;
+  double current;
+};
+
+// Throughput below baseline * (1 - tolerance) or p99 above
+// baseline * (1 + tolerance) is a regression. Scenarios missing from the
+// baseline are not compared.
+std::vector<BenchRegression> compareToBaseline(const std::vector<BenchResult>& baseline,
+                                               const std::vector<BenchResult>& current,
+                                               double tolerance);
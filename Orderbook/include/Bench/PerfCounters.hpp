@@ -0,0 +1,52 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+/* -------------------------------------------------------------------------- */
+/*                         Hardware performance counters                      */
+/* -------------------------------------------------------------------------- */
+
+enum struct PerfEvent : uint8_t {
+  Cycles,
+  Instructions,
+  L1DMisses,
+  LLCMisses,
+  BranchMisses,
+  DTLBMisses,
+};
+
+// perf_event_open counters attached to one thread (user space only, so
+// perf_event_paranoid <= 2 is enough). Every event is opened on its own:
+// whatever the kernel, PMU or container refuses is simply left out, and
+// with no counters at all available() is false and start()/stop() do
+// nothing. Counts are scaled up when the kernel had to multiplex.
+class PerfCounters {
+ public:
+  static constexpr size_t kEvents = 6;
+
+  // tid 0 = the calling thread
+  explicit PerfCounters(int tid = 0);
+  ~PerfCounters();
+  PerfCounters(const PerfCounters&) = delete;
+  PerfCounters& operator=(const PerfCounters&) = delete;
+
+  bool available() const;
+  bool has(PerfEvent e) const { return fds_[size_t(e)] >= 0; }
+
+  // Counts between start() and stop() are added to the running totals
+  void start();
+  void stop();
+
+  // Accumulated count, 0 for counters that could not be opened
+  double total(PerfEvent e) const { return totals_[size_t(e)]; }
+
+  static const char* name(PerfEvent e);
+
+  // Why nothing could be opened (strerror of the first failure), or ""
+  const char* error() const { return error_; }
+
+ private:
+  int fds_[kEvents];
+  double totals_[kEvents] = {};
+  const char* error_ = "";
+};
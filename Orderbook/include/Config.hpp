@@ -1,4 +1,5 @@
 #pragma once
+#include <cstddef>
 
 namespace Config {
 /* -------------------------------------------------------------------------- */
@@ -7,11 +8,30 @@ namespace Config {
 inline static constexpr int maxOrdersPerTrader =
     1000;  // maxinum number traders per trader to avoid overflow
 
+inline static constexpr uint64_t orderIdBlock =
+    256;  // OrderIds leased per trader from the shared counter
+
+inline static constexpr size_t tradeTapeSize =
+    4096;  // prints kept for market-data readers (power of two)
+
 /* ------------------------------- NoiseTrader ------------------------------ */
 inline static constexpr int nPSpread = 40;  // NoiseTrader price spread
 inline static constexpr int nQSpread = 100;  // NoiseTrader quantity spread
 inline static constexpr int makerP = 51;  // NoiseTrader quantity spread
 
+/* ------------------------------- WhaleTrader ------------------------------ */
+inline static constexpr int wSweepEvery = 50;  // ticks between sweeps
+inline static constexpr int wSweepLevels = 50;  // price levels a sweep may cross
+inline static constexpr int wSweepQty = 20000;  // size of one aggressive sweep
+inline static constexpr int wIcebergQty = 500;  // displayed size of a refill
+inline static constexpr int wIcebergRefills = 20;  // refills after each sweep
+
+/* ----------------------------- MomentumTrader ----------------------------- */
+inline static constexpr int mShortWindow = 8;  // fast EMA span, in prints
+inline static constexpr int mLongWindow = 32;  // slow EMA span, in prints
+inline static constexpr int mQty = 200;  // size of one aggressive order
+inline static constexpr int mAggression = 10;  // levels priced through the touch
+
 /* ------------------------------------ UI ----------------------------------- */
 inline static constexpr int candleTradesPerCandle = 200;
 inline static constexpr int candleMaxCandles = 1000;
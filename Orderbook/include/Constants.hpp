@@ -10,35 +10,68 @@
 /* -------------------------------------------------------------------------- */
 
 class Order;
-using OrderPointer = std::shared_ptr<Order>;
+using OrderPointer = Order*;  // owned by the book's OrderPool
 using Price = uint64_t;  // uint64_t is used to get maximum precision on
                          // floating point numbers
 using Quantity = uint64_t;
 using OrderId = uint64_t;
 
-enum struct Side { Buy, Sell };
+enum struct Side : uint8_t { Buy, Sell };
 
-// TODO: FillOrKill
-enum class OrderType {
+// FillAndKill fills what it can and drops the rest; FillOrKill fills in
+// full or not at all. Neither rests.
+enum class OrderType : uint8_t {
   FillAndKill,
   FillOrKill,
   GoodTillCancel,
 };
 
-enum struct RequestType {Add, Cancel, Modify, Stop, Snapshot};
+// CancelAllForOwner takes the owner from the request; its other fields
+// are ignored. Quote carries an owner's bid in the request's own order
+// fields (id, price, size) and the ask in OrderRequest::ask, and replaces
+// whatever quote that owner had resting.
+enum struct RequestType : uint8_t {Add, Cancel, Modify, Stop, Snapshot, CancelAllForOwner, Quote};
+
+// Threaded: requests are queued and matched on a dedicated worker thread.
+// Inline:   requests are matched on the submitting thread (single producer,
+//           deterministic; used by the parameter sweep).
+enum struct EngineMode { Threaded, Inline };
 
 struct Trade {
   OrderPointer bid;
   OrderPointer ask;
   Quantity qty;
+  Price price;  // execution price: the resting order's
 };
 
 using Trades = std::vector<Trade>;
 
 enum struct AckType { Accepted, Rejected, Cancelled };
 
+struct Ack {
+  OrderId orderId;
+  uint32_t owner;
+  AckType type;
+};
+
+// Reply to CancelAllForOwner: every order it cancelled, in one call.
+// orderIds is only valid for the duration of the listener.
+struct CancelBatch {
+  uint32_t owner;
+  const OrderId* orderIds;
+  size_t count;
+};
+
+// Top of book; 0 means the side is empty
+struct Quote {
+  Price bid;
+  Price ask;
+};
+
 using TradeListener = std::function<void(Trade&)>;
-using AckListener = std::function<void(OrderPointer&)>;
+using AckListener = std::function<void(Ack&)>;
+using QuoteListener = std::function<void(Quote&)>;
+using CancelBatchListener = std::function<void(CancelBatch&)>;
 
 /* -------------------------------------------------------------------------- */
 /*                          UI-only types (guarded)                           */
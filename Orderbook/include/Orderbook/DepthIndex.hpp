@@ -0,0 +1,71 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+#include "HugePageArray.hpp"
+
+// Fenwick tree of resting quantity over the blocks 0..size-1 of a price
+// ladder (block 0 = the side's best edge). Alongside the quantity it sums
+// a caller-chosen weight (the ladder uses rank * quantity), so the cost of
+// a sweep can be priced without visiting the levels it crosses. Updates
+// and both queries are O(log size). Deltas are applied modulo 2^64, so a
+// decrease is adding its negation.
+class DepthIndex
+{
+public:
+    struct Sum
+    {
+        uint64_t quantity = 0;
+        uint64_t weighted = 0;
+    };
+
+    // size must be a power of two; numaNode as for HugePageArray
+    explicit DepthIndex(size_t size, int numaNode = -1) : tree_(size + 1, numaNode), size_(size) {}
+
+    void add(size_t block, uint64_t quantity, uint64_t weighted)
+    {
+        for (size_t i = block + 1; i <= size_; i += i & (~i + 1))
+        {
+            tree_[i].quantity += quantity;
+            tree_[i].weighted += weighted;
+        }
+    }
+
+    // Sums over blocks 0..block-1
+    Sum before(size_t block) const
+    {
+        Sum s;
+        for (size_t i = block; i > 0; i -= i & (~i + 1))
+        {
+            s.quantity += tree_[i].quantity;
+            s.weighted += tree_[i].weighted;
+        }
+        return s;
+    }
+
+    // Lowest block whose running total reaches `quantity` (> 0), or size()
+    // if the whole index holds less. `ahead` receives the sums over the
+    // blocks before it.
+    size_t reach(uint64_t quantity, Sum& ahead) const
+    {
+        size_t pos = 0;
+        ahead = {};
+        for (size_t step = size_; step > 0; step >>= 1)
+        {
+            const size_t next = pos + step;
+            if (next <= size_ && ahead.quantity + tree_[next].quantity < quantity)
+            {
+                pos = next;
+                ahead.quantity += tree_[next].quantity;
+                ahead.weighted += tree_[next].weighted;
+            }
+        }
+        return pos;
+    }
+
+    size_t size() const { return size_; }
+
+private:
+    HugePageArray<Sum> tree_;  // 1-based; zero pages are an empty tree
+    size_t size_;
+};
@@ -0,0 +1,156 @@
+#pragma once
+#include <cstddef>
+#include <algorithm>
+#include <cstdint>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <linux/mempolicy.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include "../utils.hpp"
+
+// Fixed-size array of T in its own anonymous mapping, used for the order
+// pool and the request ring. Large arenas (at least one 2 MB page) are
+// backed by huge pages when OB_ENABLE_HUGE_PAGES is set:
+//
+//   1. MAP_HUGETLB from the reserved pool (vm.nr_hugepages)
+//   2. otherwise regular pages with madvise(MADV_HUGEPAGE) so transparent
+//      huge pages can back them
+//   3. otherwise (or with the option off) plain 4 KB pages
+//
+// Construction only maps the range, so it costs the same for any size.
+// Elements start as zero bytes and are never constructed or destroyed
+// here: T must either be valid when zero-filled (the ring's slots) or be
+// constructed by the owner before use (the pool's blocks). Pages fault in
+// on first use, on the touching thread's NUMA node, unless prefault() is
+// called. numaNode >= 0 places the range on that node with mbind(2)
+// whichever thread touches it: preferred by default, strictly bound with
+// OB_ENABLE_NUMA_BIND (best effort: a refused mbind leaves the default
+// policy).
+template <typename T>
+class HugePageArray
+{
+    static_assert(std::is_trivially_destructible_v<T>);
+
+public:
+    enum struct Backing : uint8_t { HugeTlb, TransparentHuge, Normal };
+
+    static constexpr size_t kHugePageSize = size_t(2) << 20;
+    static constexpr size_t kPageSize = 4096;
+
+    explicit HugePageArray(size_t count, int numaNode = -1) : size_(count)
+    {
+        const size_t bytes = count * sizeof(T);
+        backing_ = Backing::Normal;
+
+#ifdef OB_ENABLE_HUGE_PAGES
+        if (bytes >= kHugePageSize)
+        {
+            // reserves (but does not fault) the huge pages, so an empty
+            // pool fails here rather than with SIGBUS on first touch
+            length_ = roundUp(bytes, kHugePageSize);
+            void* p = mmap(nullptr, length_, PROT_READ | PROT_WRITE,
+                           MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+            if (p != MAP_FAILED)
+            {
+                data_ = static_cast<T*>(p);
+                backing_ = Backing::HugeTlb;
+            }
+        }
+#endif
+
+        if (data_ == nullptr)
+        {
+            length_ = roundUp(bytes == 0 ? 1 : bytes, kPageSize);
+            // capacity is an upper bound: reserve address space, not memory
+            void* p = mmap(nullptr, length_, PROT_READ | PROT_WRITE,
+                           MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+            if (p == MAP_FAILED) throw std::bad_alloc();
+            data_ = static_cast<T*>(p);
+
+#ifdef OB_ENABLE_HUGE_PAGES
+            // must precede the first touch, or the range is already 4 KB pages
+            if (bytes >= kHugePageSize && madvise(p, length_, MADV_HUGEPAGE) == 0)
+                backing_ = Backing::TransparentHuge;
+#endif
+        }
+
+        if (numaNode >= 0) bindToNode(numaNode);
+    }
+
+    ~HugePageArray()
+    {
+        if (data_ != nullptr) munmap(data_, length_);
+    }
+
+    HugePageArray(const HugePageArray&) = delete;
+    HugePageArray& operator=(const HugePageArray&) = delete;
+
+    T& operator[](size_t i) { return data_[i]; }
+    const T& operator[](size_t i) const { return data_[i]; }
+
+    T* data() { return data_; }
+    size_t size() const { return size_; }
+    Backing backing() const { return backing_; }
+
+    // Faults every page in up front so none faults later on a hot path.
+    // With threads > 1 the range is split across helper threads that may
+    // run on any CPU the process is allowed, so give the array a node if
+    // placement matters.
+    void prefault(size_t threads = 1)
+    {
+        const size_t step = backing_ == Backing::HugeTlb ? kHugePageSize : kPageSize;
+        const size_t pages = length_ / step;
+        auto touch = [this, step](size_t first, size_t last) {
+            volatile char* bytes = reinterpret_cast<volatile char*>(data_);
+            for (size_t page = first; page < last; ++page) bytes[page * step] = 0;
+        };
+
+        if (threads <= 1 || pages < threads)
+        {
+            touch(0, pages);
+            return;
+        }
+
+        std::vector<std::thread> helpers;
+        const size_t chunk = (pages + threads - 1) / threads;
+        for (size_t first = 0; first < pages; first += chunk)
+        {
+            helpers.emplace_back([=]() {
+                unpinThread();  // a pinned caller would pass its single core on
+                touch(first, std::min(first + chunk, pages));
+            });
+        }
+        for (std::thread& t : helpers) t.join();
+    }
+
+private:
+    static size_t roundUp(size_t n, size_t to) { return (n + to - 1) / to * to; }
+
+    // Raw syscall, so there is no libnuma dependency
+    void bindToNode(int node)
+    {
+        constexpr size_t kMaskBits = 1024;
+        if (size_t(node) >= kMaskBits) return;
+
+        unsigned long mask[kMaskBits / (8 * sizeof(unsigned long))] = {};
+        mask[size_t(node) / (8 * sizeof(unsigned long))] |= 1UL << (size_t(node) % (8 * sizeof(unsigned long)));
+#ifdef OB_ENABLE_NUMA_BIND
+        const int mode = MPOL_BIND;
+#else
+        const int mode = MPOL_PREFERRED;
+#endif
+        syscall(SYS_mbind, data_, length_, mode, mask, kMaskBits, 0);
+    }
+
+    T* data_ = nullptr;
+    size_t size_;
+    size_t length_ = 0;
+    Backing backing_;
+};
@@ -0,0 +1,98 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+#include "../Constants.hpp"
+
+// Log-linear (HDR-style) histogram of cycle counts. Values below 32 are
+// exact; above that every power of two is split into 32 buckets, so any
+// recorded value is reported within ~3%. Recording is one relaxed
+// fetch_add; any thread may read while the matching thread records, and
+// sees a slightly stale but valid distribution.
+class LatencyHistogram
+{
+public:
+    static constexpr int kSubBits = 5;
+    static constexpr size_t kSub = size_t(1) << kSubBits;
+    static constexpr size_t kBuckets = (64 - kSubBits + 1) * kSub;
+
+    void record(uint64_t value)
+    {
+        counts_[bucketOf(value)].fetch_add(1, std::memory_order_relaxed);
+        count_.fetch_add(1, std::memory_order_relaxed);
+        sum_.fetch_add(value, std::memory_order_relaxed);
+        uint64_t max = max_.load(std::memory_order_relaxed);
+        if (value > max) max_.store(value, std::memory_order_relaxed);  // single writer
+    }
+
+    uint64_t count() const { return count_.load(std::memory_order_relaxed); }
+    uint64_t max() const { return max_.load(std::memory_order_relaxed); }
+    double mean() const
+    {
+        uint64_t n = count();
+        return n ? double(sum_.load(std::memory_order_relaxed)) / double(n) : 0;
+    }
+
+    // Upper bound of the bucket holding the q-quantile (0..1), capped at max()
+    uint64_t percentile(double q) const
+    {
+        uint64_t total = 0;
+        for (size_t i = 0; i < kBuckets; ++i) total += counts_[i].load(std::memory_order_relaxed);
+        if (total == 0) return 0;
+
+        uint64_t rank = uint64_t(q * double(total));
+        if (rank >= total) rank = total - 1;
+
+        uint64_t seen = 0;
+        for (size_t i = 0; i < kBuckets; ++i)
+        {
+            seen += counts_[i].load(std::memory_order_relaxed);
+            if (seen > rank) return std::min(upperOf(i), max());
+        }
+        return max();
+    }
+
+    static size_t bucketOf(uint64_t value)
+    {
+        if (value < kSub) return size_t(value);
+        int shift = 63 - __builtin_clzll(value) - kSubBits;
+        return size_t(shift + 1) * kSub + size_t((value >> shift) & (kSub - 1));
+    }
+
+    static uint64_t upperOf(size_t bucket)
+    {
+        if (bucket < kSub) return bucket;
+        int shift = int(bucket / kSub) - 1;
+        uint64_t lower = uint64_t(kSub + bucket % kSub) << shift;
+        return lower + ((uint64_t(1) << shift) - 1);
+    }
+
+private:
+    std::atomic<uint64_t> counts_[kBuckets]{};
+    std::atomic<uint64_t> count_{0};
+    std::atomic<uint64_t> sum_{0};
+    std::atomic<uint64_t> max_{0};
+};
+
+// Where one request type spends its time, in TSC cycles:
+//   queue   submitRequest -> dequeued by the matching thread
+//   service dequeued -> matching done
+//   total   submitRequest -> matching done
+struct RequestLatency
+{
+    LatencyHistogram queue;
+    LatencyHistogram service;
+    LatencyHistogram total;
+};
+
+struct LatencyStats
+{
+    static constexpr size_t kTypes = size_t(RequestType::Quote) + 1;
+
+    RequestLatency byType[kTypes];
+
+    RequestLatency& operator[](RequestType type) { return byType[size_t(type)]; }
+    const RequestLatency& operator[](RequestType type) const { return byType[size_t(type)]; }
+};
@@ -0,0 +1,98 @@
+#pragma once
+#include <algorithm>
+#include <cstddef>
+#include <new>
+#include <vector>
+
+// Recycling free list for the nodes of the engine's node-based containers
+// (the price level maps). Nodes come from chunks that are kept until the
+// arena dies, so once a container has reached its high-water mark,
+// inserting and erasing never touch the general-purpose heap. The first
+// node size requested fixes the slot size; larger requests (a container
+// asking for an array) go to operator new.
+class NodeArena
+{
+public:
+    explicit NodeArena(size_t reserveNodes = 0) : reserve_(reserveNodes) {}
+
+    ~NodeArena()
+    {
+        for (void* chunk : chunks_) ::operator delete(chunk);
+    }
+
+    NodeArena(const NodeArena&) = delete;
+    NodeArena& operator=(const NodeArena&) = delete;
+
+    void* allocate(size_t bytes)
+    {
+        if (nodeSize_ == 0)
+            nodeSize_ = roundUp(std::max(bytes, sizeof(FreeNode)), alignof(std::max_align_t));
+        if (bytes > nodeSize_) return ::operator new(bytes);
+
+        if (free_ == nullptr) grow();
+        FreeNode* node = free_;
+        free_ = node->next;
+        return node;
+    }
+
+    void deallocate(void* p, size_t bytes)
+    {
+        if (bytes > nodeSize_)
+        {
+            ::operator delete(p);
+            return;
+        }
+        FreeNode* node = static_cast<FreeNode*>(p);
+        node->next = free_;
+        free_ = node;
+    }
+
+    size_t chunks() const { return chunks_.size(); }
+
+private:
+    struct FreeNode
+    {
+        FreeNode* next;
+    };
+
+    static constexpr size_t kChunkNodes = 256;
+
+    static size_t roundUp(size_t n, size_t to) { return (n + to - 1) / to * to; }
+
+    void grow()
+    {
+        const size_t nodes = chunks_.empty() ? std::max(reserve_, kChunkNodes) : kChunkNodes;
+        char* chunk = static_cast<char*>(::operator new(nodes * nodeSize_));
+        chunks_.push_back(chunk);
+        for (size_t i = nodes; i-- > 0;)
+        {
+            FreeNode* node = reinterpret_cast<FreeNode*>(chunk + i * nodeSize_);
+            node->next = free_;
+            free_ = node;
+        }
+    }
+
+    const size_t reserve_;
+    size_t nodeSize_ = 0;
+    FreeNode* free_ = nullptr;
+    std::vector<void*> chunks_;
+};
+
+// std::allocator replacement that draws single nodes from a NodeArena
+template <typename T>
+struct NodeAllocator
+{
+    using value_type = T;
+
+    NodeArena* arena;
+
+    explicit NodeAllocator(NodeArena* a) : arena(a) {}
+    template <typename U>
+    NodeAllocator(const NodeAllocator<U>& other) : arena(other.arena) {}
+
+    T* allocate(size_t n) { return static_cast<T*>(arena->allocate(n * sizeof(T))); }
+    void deallocate(T* p, size_t n) { arena->deallocate(p, n * sizeof(T)); }
+
+    template <typename U>
+    bool operator==(const NodeAllocator<U>& other) const { return arena == other.arena; }
+};
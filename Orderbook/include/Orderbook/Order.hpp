@@ -1,11 +1,13 @@
 #pragma once
 #include <cstdint>
 #include <algorithm>
-#include <deque>
 #include <ostream>
 
 #include "../Constants.hpp"
 
+class Orderbook;
+class PriceLevel;
+
 class Order
 {
 public:
@@ -34,6 +36,7 @@ public:
     // Public API
     const bool isFilled() const { return getQuantity() == 0; }
     void Fill(Quantity amount) { remainingQuantity_ -= std::min(remainingQuantity_, amount); }
+    void reduceTo(Quantity quantity) { remainingQuantity_ = std::min(remainingQuantity_, quantity); }
     void cancel() { valid_ = false; }
 
     // Overloading
@@ -41,20 +44,64 @@ public:
 
 private:
     uint32_t owner_;
-    Price price_;
     OrderType orderType_;
+    Price price_;
     Quantity initialQuantity_;
     Quantity remainingQuantity_;
     OrderId orderId_;
     Side side_;
     bool valid_ = true; // used to mark orders as ghosts for better cache locality
+    bool quoteLeg_ = false;  // rests as one side of its owner's Quote
+
+    // Intrusive links of the price level queue while the order rests
+    friend class PriceLevel;
+    Order* prev_ = nullptr;
+    Order* next_ = nullptr;
+
+    // Intrusive links of the owner's list of resting orders
+    friend class Orderbook;
+    Order* ownerPrev_ = nullptr;
+    Order* ownerNext_ = nullptr;
 };
 
-struct OrderRequest
+// One side of a two-sided Quote
+struct QuoteLeg
 {
-    RequestType type;
-    Order order;
+    OrderId orderId;
+    Price price;
+    Quantity quantity;
 };
 
+// What a request carries through the ring: the order's fields as
+// submitted, not the book's pooled Order (fill state and intrusive links
+// are engine-only). 56 bytes, so a ring slot and its flag share one cache
+// line.
+struct OrderRequest
+{
+    OrderRequest() = default;
+    OrderRequest(RequestType type, const Order &order)
+        : type(type),
+          orderType(order.getOrderType()),
+          side(order.getSide()),
+          owner(order.getOwner()),
+          orderId(order.getOrderId()),
+          price(order.getPrice()),
+          quantity(order.getQuantity())
+    {
+    }
 
-using OrderList = std::deque<OrderPointer>;
\ No newline at end of file
+    RequestType type = RequestType::Add;
+    OrderType orderType = OrderType::GoodTillCancel;
+    Side side = Side::Buy;
+    uint32_t owner = 0;
+    OrderId orderId = 0;
+    Price price = 0;
+    Quantity quantity = 0;
+    QuoteLeg ask{};  // Quote only: the ask side; the fields above are the bid
+#ifdef OB_ENABLE_LATENCY
+    uint64_t submitTsc = 0;  // stamped by Orderbook::submitRequest
+#endif
+};
+#ifndef OB_ENABLE_LATENCY
+static_assert(sizeof(OrderRequest) == 56, "OrderRequest no longer fits a ring slot's cache line");
+#endif
@@ -0,0 +1,96 @@
+#pragma once
+#include <cstdint>
+#include <memory>
+
+#include "../Constants.hpp"
+
+// OrderId (or another 64-bit key) -> resting Order*: flat open addressing
+// (linear probing, backward-shift deletion, no tombstones). The table doubles at half load
+// and never shrinks, so steady-state trading neither allocates nor frees.
+class OrderIndex
+{
+public:
+    explicit OrderIndex(size_t capacity = 1024) { rehash(capacity); }
+
+    size_t size() const { return size_; }
+
+    Order* find(OrderId id) const
+    {
+        for (size_t i = slot(id);; i = (i + 1) & mask_)
+        {
+            if (slots_[i].order == nullptr) return nullptr;
+            if (slots_[i].id == id) return slots_[i].order;
+        }
+    }
+
+    // Replaces the entry if `id` is already present
+    void insert(OrderId id, Order* order) { exchange(id, order); }
+
+    // insert() that returns the entry it replaced, nullptr if none
+    Order* exchange(OrderId id, Order* order)
+    {
+        if ((size_ + 1) * 2 > capacity_) rehash(capacity_ * 2);
+        size_t i = slot(id);
+        while (slots_[i].order != nullptr && slots_[i].id != id) i = (i + 1) & mask_;
+        Order* previous = slots_[i].order;
+        if (previous == nullptr) ++size_;
+        slots_[i] = {id, order};
+        return previous;
+    }
+
+    bool erase(OrderId id)
+    {
+        size_t i = slot(id);
+        while (slots_[i].id != id || slots_[i].order == nullptr)
+        {
+            if (slots_[i].order == nullptr) return false;
+            i = (i + 1) & mask_;
+        }
+
+        // shift later members of the probe run back into the hole
+        size_t hole = i;
+        for (size_t j = (hole + 1) & mask_; slots_[j].order != nullptr; j = (j + 1) & mask_)
+        {
+            size_t home = slot(slots_[j].id);
+            if (((j - home) & mask_) >= ((j - hole) & mask_))
+            {
+                slots_[hole] = slots_[j];
+                hole = j;
+            }
+        }
+        slots_[hole].order = nullptr;
+        --size_;
+        return true;
+    }
+
+private:
+    struct Slot
+    {
+        OrderId id;
+        Order* order;  // nullptr marks an empty slot, so any id is a valid key
+    };
+
+    size_t slot(OrderId id) const
+    {
+        return (size_t)((id * 0x9e3779b97f4a7c15ULL) >> 32) & mask_;
+    }
+
+    void rehash(size_t capacity)
+    {
+        std::unique_ptr<Slot[]> old = std::move(slots_);
+        size_t oldCapacity = old ? capacity_ : 0;
+
+        capacity_ = capacity;
+        mask_ = capacity - 1;
+        size_ = 0;
+        slots_ = std::make_unique<Slot[]>(capacity);  // value-init: empty
+
+        for (size_t i = 0; i < oldCapacity; ++i)
+            if (old[i].order != nullptr) insert(old[i].id, old[i].order);
+    }
+
+    std::unique_ptr<Slot[]> slots_;
+    size_t capacity_{0};
+    size_t mask_{0};
+    size_t size_{0};
+};
@@ -1,7 +1,21 @@
 #pragma once
-#include <vector>
+#include <algorithm>
+#include <atomic>
 #include <memory>
+#include <new>
+#include <thread>
 
+#include "HugePageArray.hpp"
+#include "../Scheduler/EventSignal.hpp"
+#include "../utils.hpp"
+
+// Fixed-size blocks carved from slabs of slabBlocks each. Slabs are added
+// on demand up to maxBlocks and never move, so pointers into the pool stay
+// valid for the pool's lifetime. With backgroundGrowth a helper thread
+// keeps one spare slab mapped and prefaulted ahead of need: running past a
+// slab is then a pointer swap on the acquiring thread. Only if the helper
+// is a whole slab behind does the acquiring thread map one itself (counted
+// by inlineGrowths()). Past maxBlocks, acquire() returns nullptr.
 template <typename T> class OrderPool
 {
 private:
@@ -10,43 +24,150 @@ private:
         T object;
         Block* next;
     };
+    using Slab = HugePageArray<Block>;
+
+    const size_t maxBlocks_;
+    const size_t slabBlocks_;
+    const size_t maxSlabs_;
+    const int numaNode_;
+
+    // Released blocks go on the free list; fresh ones are carved from the
+    // newest slab with a bump pointer, so nothing is linked up front.
+    std::unique_ptr<std::unique_ptr<Slab>[]> slabs_;  // sized once, never reallocated
+    size_t slabCount_ = 0;
+    Block* freehead_ = nullptr;
+    Block* carve_ = nullptr;
+    Block* carveEnd_ = nullptr;
+    uint64_t inlineGrowths_ = 0;
+
+    // Slabs mapped so far, by either thread; bounded by maxSlabs_
+    std::atomic<size_t> reserved_{0};
+
+    // Background growth: the grower fills spare_ whenever it is empty
+    std::atomic<Slab*> spare_{nullptr};
+    std::atomic<bool> growing_{false};
+    EventSignal growSignal_;
+    std::thread grower_;
 
-    std::vector<Block> pool_;
-    Block* freehead_;
+    bool reserveSlab()
+    {
+        if (reserved_.fetch_add(1, std::memory_order_relaxed) < maxSlabs_) return true;
+        reserved_.fetch_sub(1, std::memory_order_relaxed);
+        return false;
+    }
+
+    bool addSlab()
+    {
+        Slab* slab = spare_.exchange(nullptr, std::memory_order_acquire);
+        if (slab != nullptr)
+        {
+            growSignal_.notify();
+        }
+        else
+        {
+            if (!reserveSlab()) return false;
+            slab = new Slab(slabBlocks_, numaNode_);
+            if (grower_.joinable()) inlineGrowths_++;
+        }
+
+        // the last slab is cut short so the limit is exact
+        const size_t usable = std::min(slabBlocks_, maxBlocks_ - slabCount_ * slabBlocks_);
+        slabs_[slabCount_++].reset(slab);
+        carve_ = slab->data();
+        carveEnd_ = carve_ + usable;
+        return true;
+    }
+
+    void growLoop()
+    {
+        // created by the (possibly pinned) matching thread: get off its core
+        unpinThread();
+        while (growing_.load(std::memory_order_acquire))
+        {
+            uint32_t seen = growSignal_.prepare();
+            if (spare_.load(std::memory_order_acquire) == nullptr && reserveSlab())
+            {
+                try
+                {
+                    Slab* slab = new Slab(slabBlocks_, numaNode_);
+                    slab->prefault();
+                    spare_.store(slab, std::memory_order_release);
+                    continue;
+                }
+                catch (const std::bad_alloc&)
+                {
+                    reserved_.fetch_sub(1, std::memory_order_relaxed);
+                }
+            }
+            growSignal_.wait(seen);
+        }
+    }
 
 public:
-    OrderPool(size_t size) {
-        pool_.resize(size);
-        freehead_ = &pool_[0];
+    static constexpr size_t kSlabBlocks = size_t(1) << 16;
+
+    // numaNode >= 0 places the pool's pages on that node (see HugePageArray)
+    OrderPool(size_t maxBlocks, int numaNode = -1, bool backgroundGrowth = false,
+              size_t slabBlocks = kSlabBlocks)
+        : maxBlocks_(maxBlocks),
+          slabBlocks_(std::max<size_t>(1, std::min(slabBlocks, maxBlocks))),
+          maxSlabs_((maxBlocks + slabBlocks_ - 1) / slabBlocks_),
+          numaNode_(numaNode),
+          slabs_(std::make_unique<std::unique_ptr<Slab>[]>(maxSlabs_))
+    {
+        addSlab();
 
-        for (size_t i = 0; i < size - 1; i++)
+        if (backgroundGrowth && maxSlabs_ > 1)
         {
-            pool_[i].next = &pool_[i+1];
+            growing_.store(true, std::memory_order_release);
+            grower_ = std::thread(&OrderPool::growLoop, this);
         }
-        pool_[size - 1].next = nullptr;
     }
 
-    template <typename... Args>
-    std::shared_ptr<T> acquire(Args&&... args)
+    ~OrderPool()
     {
-        if (freehead_ == nullptr) { return nullptr; };
+        if (grower_.joinable())
+        {
+            growing_.store(false, std::memory_order_release);
+            growSignal_.notify();
+            grower_.join();
+        }
+        delete spare_.load(std::memory_order_acquire);
+    }
+
+    OrderPool(const OrderPool&) = delete;
+    OrderPool& operator=(const OrderPool&) = delete;
 
-        Block* block = freehead_;
-        freehead_ = block->next;
+    // Faults the current slab in now instead of on first use (spare slabs
+    // are prefaulted by the grower)
+    void prefault(size_t threads = 1) { slabs_[slabCount_ - 1]->prefault(threads); }
+
+    size_t capacity() const { return maxBlocks_; }
+    size_t slabs() const { return slabCount_; }
+    uint64_t inlineGrowths() const { return inlineGrowths_; }
+
+    template <typename... Args>
+    T* acquire(Args&&... args)
+    {
+        // Recently released blocks first (still in cache), then fresh ones
+        Block* block;
+        if (freehead_ != nullptr) [[likely]]
+        {
+            block = freehead_;
+            freehead_ = block->next;
+        }
+        else
+        {
+            if (carve_ == carveEnd_ && !addSlab()) return nullptr;
+            block = carve_++;
+        }
 
         T* ptr = &(block->object);
 
         // Pass R-Values to the Order constructor and write it in the place of the ptr
         new (ptr) T(std::forward<Args>(args)...);
 
-        // return a shared_ptr with a no-op deleter; pool manages object lifetime
-        return std::shared_ptr<T>(ptr, [](T*){});
-    }
-
-    void release(std::shared_ptr<T>& ptr)
-    {
-        release(ptr.get());
-        ptr.reset();
+        return ptr;
     }
 
     void release(T* ptr)
@@ -59,4 +180,4 @@ public:
         freehead_ = block;
     }
 
-};
\ No newline at end of file
+};
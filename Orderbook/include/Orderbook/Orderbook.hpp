@@ -1,18 +1,27 @@
 #pragma once
 #include <atomic>
 #include <algorithm>
+#include <exception>
 #include <map>
-#include <unordered_map>
+#include <optional>
 #include <thread>
+#include <vector>
 
 #ifdef OB_ENABLE_UI
 #include <deque>
 #include <mutex>
 #endif
 
+#ifdef OB_ENABLE_LATENCY
+#include <memory>
+#include "LatencyStats.hpp"
+#endif
+
 #include "../Constants.hpp"
 #include "Order.hpp"
+#include "OrderIndex.hpp"
 #include "OrderPool.hpp"
+#include "PriceLadder.hpp"
 #include "RingBuffer.hpp"
 
 class Orderbook
@@ -21,13 +30,52 @@ public:
     void submitRequest(OrderRequest& request);
     size_t size() const { return size_; };
     uint64_t matchedTrades() const { return matchedTrades_.load(); };
-
-    explicit Orderbook(size_t maxOrders, int coreId = -1);
+    uint64_t matchedVolume() const { return matchedVolume_.load(); };
+    // Requests fully processed so far; with a single producer request i is
+    // done once this exceeds i (used by the open-loop benchmark)
+    uint64_t processedRequests() const { return processed_.load(std::memory_order_acquire); };
+
+    // Kernel thread id of the matching thread (for per-thread profiling such
+    // as perf_event_open). 0 in inline mode, where the submitting thread
+    // does the matching.
+    int matchingThreadId() const;
+
+    // maxOrders is a hard limit on resting plus in-flight orders: beyond it
+    // an Add is acked Rejected. Engine memory is mapped lazily (the pool
+    // grows by slabs), so construction time does not depend on maxOrders.
+    // prefaultThreads > 0 faults the first pool slab and the ring in up
+    // front, split across that many threads.
+    explicit Orderbook(size_t maxOrders, int coreId = -1,
+                       EngineMode mode = EngineMode::Threaded,
+                       size_t prefaultThreads = 0);
 
     Price topBidPrice() const;
     Price topAskPrice() const;
 
+    // Liquidity resting on `side`, best price first, in O(log n). Not
+    // synchronised with matching: call on the matching thread (listeners)
+    // or on an inline book.
+    // Quantity at `limit` or better
+    Quantity depthTo(Side side, Price limit) const;
+    // Price at which a sweep of `quantity` would stop; nullopt if the side
+    // holds less than that
+    std::optional<Price> priceFor(Side side, Quantity quantity) const;
+    // Volume-weighted price of that sweep; nullopt if the side holds less
+    std::optional<double> sweepVwap(Side side, Quantity quantity) const;
+
     void setTradeListener(TradeListener listener) { listener_ = listener; };
+    void setAckListener(AckListener listener) { ackListener_ = listener; };
+    // Fired on the matching thread whenever the top of book changes
+    void setQuoteListener(QuoteListener listener) { quoteListener_ = listener; };
+    // Replies to CancelAllForOwner. Without one, each cancelled order gets
+    // its own Cancelled ack instead.
+    void setCancelBatchListener(CancelBatchListener listener) { cancelBatchListener_ = listener; };
+
+#ifdef OB_ENABLE_LATENCY
+    /// Live per-request-type histograms in TSC cycles (see tscPerNs());
+    /// safe to read from any thread while the book is running.
+    const LatencyStats& latencyStats() const { return *latency_; }
+#endif
 
 #ifdef OB_ENABLE_UI
     /// Thread-safe: returns the latest snapshot taken by the worker thread.
@@ -40,32 +88,72 @@ public:
     ~Orderbook();
 
 private:
-    void addOrder(const Order& order);
-    void cancelOrder(const OrderId& orderId);
-    void modifyOrder(const Order& order);
+    // The order as it rests after matching, nullptr if it does not rest
+    OrderPointer addOrder(const OrderRequest& request);
+    void cancelOrder(const OrderRequest& request, bool notify = true);
+    void modifyOrder(const OrderRequest& request);
+    void cancelAllForOwner(uint32_t owner);
+    void quote(const OrderRequest& request);
+    OrderPointer keepQuoteLeg(Side side, uint32_t owner, Price price, Quantity quantity);
+    void placeQuoteLeg(OrderPointer kept, const OrderRequest& leg);
+    OrderIndex& quoteLegs(Side side) { return side == Side::Buy ? quoteBids_ : quoteAsks_; }
     void matchOrders(OrderPointer newOrder);
 
-    inline void onMatch(const OrderPointer& b, const OrderPointer& a, Quantity& qty);
+    // Book-wide bookkeeping for an order that starts or stops resting (its
+    // price level is the caller's); untrack() also frees the order
+    void track(OrderPointer order);
+    void untrack(OrderPointer order);
 
-    void processLoop();
+    inline void onMatch(const OrderPointer& b, const OrderPointer& a, Quantity& qty, Price price);
+    inline void onAck(OrderId orderId, uint32_t owner, AckType type);
+    inline void publishQuote();
 
-    OrderPool<Order> orderPool_;
-    RingBuffer<OrderRequest> buffer_;
+    void processRequest(const OrderRequest& request);
+    void processLoop(size_t maxOrders, int coreId, size_t prefaultThreads);
+    void initEngine(size_t maxOrders, int numaNode, size_t prefaultThreads);
 
-    std::thread workerThread_;
+#ifdef OB_ENABLE_LATENCY
+    inline void recordLatency(const OrderRequest& request, uint64_t dequeued);
+    std::unique_ptr<LatencyStats> latency_;
+#endif
 
-    std::unordered_map<Price, Quantity> bidLevels_;
-    std::unordered_map<Price, Quantity> askLevels_;
+    EngineMode mode_;
 
-    std::map<Price, OrderList, std::greater<Price>> bids_;
-    std::map<Price, OrderList, std::less<Price>> asks_;
-    std::unordered_map<OrderId, OrderPointer> orders_;
+    // Engine arenas are built by initEngine() on the matching thread, after
+    // it has been pinned, so their pages are first touched on its NUMA node.
+    // Inline books have no ring.
+    std::optional<OrderPool<Order>> orderPool_;
+    std::optional<RingBuffer<OrderRequest>> buffer_;
+    std::optional<PriceLadder<Side::Buy>> bids_;
+    std::optional<PriceLadder<Side::Sell>> asks_;
+
+    std::thread workerThread_;
+    std::atomic<int> workerTid_{0};  // set once the engine is ready, -1 if it failed
+    std::exception_ptr initError_;
+
+    // Orders queue intrusively inside their level and the ladders' level
+    // arrays are mapped once, so steady-state trading does no
+    // general-purpose heap allocation.
+    OrderIndex orders_;
+    // owner -> its most recently rested order, the head of a list linked
+    // through Order::ownerPrev_/ownerNext_
+    OrderIndex ownerHeads_;
+    std::vector<OrderId> batchIds_;  // reused by every CancelAllForOwner
+    // owner -> its resting Quote leg on each side
+    OrderIndex quoteBids_;
+    OrderIndex quoteAsks_;
 
     size_t size_{0};
 
     TradeListener listener_;
+    AckListener ackListener_;
+    QuoteListener quoteListener_;
+    CancelBatchListener cancelBatchListener_;
+    Quote lastQuote_{0, 0};
 
     std::atomic<uint64_t> matchedTrades_{0};
+    std::atomic<uint64_t> matchedVolume_{0};
+    std::atomic<uint64_t> processed_{0};
 
 #ifdef OB_ENABLE_UI
     /* ------------------------------ Snapshot -------------------------------- */
@@ -109,12 +197,9 @@ inline void Orderbook::recordTradePrice(Price price, Quantity qty) {
 
 inline void Orderbook::takeSnapshot() {
   OrderBookSnapshot snap;
-  for (auto& [p, q] : bidLevels_) snap.bidLevels.push_back({p, q});
-  std::sort(snap.bidLevels.begin(), snap.bidLevels.end(),
-            [](auto& a, auto& b) { return a.first > b.first; });
-
-  for (auto& [p, q] : askLevels_) snap.askLevels.push_back({p, q});
-  std::sort(snap.askLevels.begin(), snap.askLevels.end(), [](auto& a, auto& b) { return a.first > b.first; });
+  // both sides highest price first
+  bids_->forEach([&snap](Price p, const PriceLevel& level) { snap.bidLevels.push_back({p, level.volume}); });
+  asks_->forEach([&snap](Price p, const PriceLevel& level) { snap.askLevels.push_front({p, level.volume}); });
 
   snap.candles = candleHistory_;
   if (currentCandle_.isValid()) snap.candles.push_back(currentCandle_);
@@ -0,0 +1,91 @@
+#pragma once
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+
+// Occupancy of kBits price slots as a three-level 64-ary bitmap: a leaf
+// bit per slot, a middle bit per non-empty leaf word, a top bit per
+// non-empty middle word. Finding the next set slot in either direction is
+// at most three masked tzcnt/lzcnt steps, however far away it is.
+class PriceBitmap
+{
+public:
+    static constexpr size_t kBits = size_t(64) * 64 * 64;
+    static constexpr size_t kNone = kBits;
+
+    bool empty() const { return top_ == 0; }
+
+    bool test(size_t i) const { return (leaf_[i >> 6] >> (i & 63)) & 1; }
+
+    // Slots 64 * w .. 64 * w + 63 as one word
+    uint64_t word(size_t w) const { return leaf_[w]; }
+
+    void set(size_t i)
+    {
+        const size_t w = i >> 6;
+        leaf_[w] |= bit(i & 63);
+        mid_[w >> 6] |= bit(w & 63);
+        top_ |= bit(w >> 6);
+    }
+
+    void reset(size_t i)
+    {
+        const size_t w = i >> 6;
+        if ((leaf_[w] &= ~bit(i & 63)) != 0) return;
+        if ((mid_[w >> 6] &= ~bit(w & 63)) != 0) return;
+        top_ &= ~bit(w >> 6);
+    }
+
+    // Lowest set slot >= i, or kNone
+    size_t next(size_t i) const
+    {
+        if (i >= kBits) return kNone;
+        size_t w = i >> 6;
+        if (uint64_t bits = leaf_[w] & above(i & 63)) return (w << 6) | std::countr_zero(bits);
+
+        size_t m = w >> 6;
+        uint64_t words = (w & 63) == 63 ? 0 : mid_[m] & above((w & 63) + 1);
+        if (words == 0)
+        {
+            uint64_t mids = m == 63 ? 0 : top_ & above(m + 1);
+            if (mids == 0) return kNone;
+            m = std::countr_zero(mids);
+            words = mid_[m];
+        }
+        w = (m << 6) | std::countr_zero(words);
+        return (w << 6) | std::countr_zero(leaf_[w]);
+    }
+
+    // Highest set slot <= i, or kNone
+    size_t prev(size_t i) const
+    {
+        if (i >= kBits) i = kBits - 1;
+        size_t w = i >> 6;
+        if (uint64_t bits = leaf_[w] & upTo(i & 63)) return (w << 6) | highest(bits);
+
+        size_t m = w >> 6;
+        uint64_t words = (w & 63) == 0 ? 0 : mid_[m] & upTo((w & 63) - 1);
+        if (words == 0)
+        {
+            uint64_t mids = m == 0 ? 0 : top_ & upTo(m - 1);
+            if (mids == 0) return kNone;
+            m = highest(mids);
+            words = mid_[m];
+        }
+        w = (m << 6) | highest(words);
+        return (w << 6) | highest(leaf_[w]);
+    }
+
+    size_t first() const { return next(0); }
+    size_t last() const { return prev(kBits - 1); }
+
+private:
+    static constexpr uint64_t bit(size_t n) { return uint64_t(1) << n; }
+    static constexpr uint64_t above(size_t n) { return ~uint64_t(0) << n; }          // bits >= n
+    static constexpr uint64_t upTo(size_t n) { return ~uint64_t(0) >> (63 - n); }  // bits <= n
+    static size_t highest(uint64_t bits) { return 63 - std::countl_zero(bits); }
+
+    uint64_t top_ = 0;
+    uint64_t mid_[64] = {};
+    uint64_t leaf_[64 * 64] = {};
+};
@@ -0,0 +1,304 @@
+#pragma once
+#include <algorithm>
+#include <bit>
+#include <functional>
+#include <map>
+#include <optional>
+#include <type_traits>
+
+#include "../Constants.hpp"
+#include "DepthIndex.hpp"
+#include "HugePageArray.hpp"
+#include "NodeArena.hpp"
+#include "PriceBitmap.hpp"
+#include "PriceLevel.hpp"
+
+// What a marketable order for some quantity would take from one side
+struct SweepCost
+{
+    Quantity quantity = 0;  // less than asked for if the side is too thin
+    Price worst = 0;        // last (worst) price reached
+    double notional = 0;    // sum of price * quantity taken
+
+    double vwap() const { return quantity ? notional / double(quantity) : 0; }
+};
+
+// One side of the book, best price first (highest bid, lowest ask).
+// Levels within a window of kTicks ticks live in a flat array indexed by
+// tick, with a PriceBitmap of the non-empty ones, so the best level and
+// the next level after an emptied one are a few bit scans away. The window
+// is centred on the first price the side sees and re-centred whenever the
+// side runs empty; prices outside it go to an overflow map, so any price
+// is accepted. Each price lives in exactly one of the two.
+//
+// A DepthIndex over the window tracks resting quantity per block of 64
+// ticks (one bitmap word), so depth and sweep-cost queries are O(log
+// kTicks) plus a walk of the levels in the one block where they end and
+// of the overflow levels they cover. Keeping blocks, not ticks, leaves
+// each update a dozen steps over a 64 KB tree. Volume changes must go
+// through push(), erase(), shrink() and reduce() to keep it in step; level() only
+// creates the level.
+template <Side S>
+class PriceLadder
+{
+    using Better = std::conditional_t<S == Side::Buy, std::greater<Price>, std::less<Price>>;
+    using OverflowAllocator = NodeAllocator<std::pair<const Price, PriceLevel>>;
+
+public:
+    static constexpr size_t kTicks = PriceBitmap::kBits;
+    static constexpr size_t kBlock = 64;
+    static constexpr size_t kBlocks = kTicks / kBlock;
+
+    // numaNode >= 0 places the level array on that node (see HugePageArray)
+    explicit PriceLadder(int numaNode = -1) : levels_(kTicks, numaNode), depth_(kBlocks, numaNode) {}
+
+    PriceLadder(const PriceLadder&) = delete;
+    PriceLadder& operator=(const PriceLadder&) = delete;
+
+    bool empty() const { return levelCount_ == 0; }
+    size_t levels() const { return levelCount_; }
+
+    // Price of the best level; the side must not be empty
+    Price best() const
+    {
+        const size_t slot = S == Side::Buy ? bitmap_.last() : bitmap_.first();
+        if (overflow_.empty()) [[likely]] return base_ + slot;
+        const Price spilled = overflow_.begin()->first;
+        return slot == PriceBitmap::kNone || Better{}(spilled, base_ + slot) ? spilled : base_ + slot;
+    }
+
+    // Best non-empty level at `from` or worse (bids: <= from, asks: >= from)
+    std::optional<Price> next(Price from) const
+    {
+        std::optional<Price> found;
+        if (size_t slot = nextSlot(from); slot != PriceBitmap::kNone) found = base_ + slot;
+
+        if (!overflow_.empty())
+        {
+            auto it = overflow_.lower_bound(from);
+            if (it != overflow_.end() && (!found || Better{}(it->first, *found))) found = it->first;
+        }
+        return found;
+    }
+
+    // nullptr if there is no level at `price`
+    PriceLevel* find(Price price)
+    {
+        if (inWindow(price)) return bitmap_.test(price - base_) ? &levels_[price - base_] : nullptr;
+        auto it = overflow_.find(price);
+        return it == overflow_.end() ? nullptr : &it->second;
+    }
+
+    // The level at `price`, added if there is none
+    PriceLevel& level(Price price)
+    {
+        if (levelCount_ == 0) recentre(price);
+        if (inWindow(price))
+        {
+            const size_t slot = price - base_;
+            if (!bitmap_.test(slot))
+            {
+                bitmap_.set(slot);
+                ++levelCount_;
+            }
+            return levels_[slot];
+        }
+        auto [it, added] = overflow_.try_emplace(price);
+        levelCount_ += added;
+        return it->second;
+    }
+
+    // Drops the (empty) level at `price`
+    void remove(Price price)
+    {
+        if (inWindow(price))
+        {
+            levels_[price - base_] = PriceLevel{};
+            bitmap_.reset(price - base_);
+        }
+        else
+        {
+            overflow_.erase(price);
+        }
+        --levelCount_;
+    }
+
+    // Queues `order` at its price with its remaining quantity
+    void push(Order* order)
+    {
+        level(order->getPrice()).push_back(order);
+        account(order->getPrice(), order->getQuantity());
+    }
+
+    // Unlinks a resting order, dropping its level if that empties it
+    void erase(Order* order)
+    {
+        const Price price = order->getPrice();
+        PriceLevel& at = *find(price);
+        at.erase(order);
+        account(price, -order->getQuantity());
+        if (at.empty()) remove(price);
+    }
+
+    // Cuts a resting order down to `quantity` (at most its remaining
+    // quantity) where it stands, keeping its place in the queue
+    void shrink(Order* order, Quantity quantity)
+    {
+        const Price price = order->getPrice();
+        reduce(price, *find(price), order->getQuantity() - quantity);
+        order->reduceTo(quantity);
+    }
+
+    // Takes `quantity` off the level at `price` (a fill against it)
+    void reduce(Price price, PriceLevel& at, Quantity quantity)
+    {
+        at.volume -= quantity;
+        account(price, -quantity);
+    }
+
+    // Resting quantity at `limit` or better
+    Quantity depthTo(Price limit) const
+    {
+        Quantity total = 0;
+        for (auto& [price, at] : overflow_)
+        {
+            if (Better{}(limit, price)) break;
+            total += at.volume;
+        }
+
+        const size_t lastRank = S == Side::Buy
+            ? (limit < base_ ? kTicks - 1 : limit - base_ < kTicks ? rank(limit - base_) : kNoRank)
+            : (limit < base_ ? kNoRank : rank(std::min<Price>(limit - base_, kTicks - 1)));
+        if (lastRank == kNoRank) return total;
+
+        const size_t block = lastRank / kBlock;
+        total += depth_.before(block).quantity;
+        walkBlock(block, [&total, lastRank](size_t r, const PriceLevel& at) {
+            if (r > lastRank) return false;
+            total += at.volume;
+            return true;
+        });
+        return total;
+    }
+
+    // Best-first walk of `quantity` through the side, without changing it
+    SweepCost sweep(Quantity quantity) const
+    {
+        SweepCost cost;
+        auto take = [&cost, quantity](Price price, Quantity available) {
+            const Quantity q = std::min(available, quantity - cost.quantity);
+            cost.quantity += q;
+            cost.notional += double(price) * double(q);
+            if (q) cost.worst = price;
+            return cost.quantity == quantity;
+        };
+
+        // overflow levels better than the whole window come first
+        auto it = overflow_.begin();
+        for (; it != overflow_.end() && Better{}(it->first, base_ + rankSlot(0)); ++it)
+            if (take(it->first, it->second.volume)) return cost;
+
+        DepthIndex::Sum ahead;
+        const size_t block = depth_.reach(quantity - cost.quantity, ahead);
+        cost.quantity += ahead.quantity;
+        cost.notional += notional(ahead);
+        if (block < kBlocks)
+        {
+            walkBlock(block, [&](size_t r, const PriceLevel& at) { return !take(base_ + rankSlot(r), at.volume); });
+            return cost;
+        }
+        if (ahead.quantity) cost.worst = base_ + (S == Side::Buy ? bitmap_.first() : bitmap_.last());
+
+        for (; it != overflow_.end(); ++it)
+            if (take(it->first, it->second.volume)) break;
+        return cost;
+    }
+
+    // Calls f(price, level) for each level, best first
+    template <typename F>
+    void forEach(F&& f) const
+    {
+        for (std::optional<Price> p = empty() ? std::nullopt : std::optional<Price>(best()); p;)
+        {
+            f(*p, inWindow(*p) ? levels_[*p - base_] : overflow_.find(*p)->second);
+            if (S == Side::Buy ? *p == 0 : *p == ~Price(0)) break;
+            p = next(S == Side::Buy ? *p - 1 : *p + 1);
+        }
+    }
+
+private:
+    static constexpr size_t kNoRank = ~size_t(0);
+
+    // Depth ranks run from the side's best edge of the window
+    static size_t rank(size_t slot) { return S == Side::Buy ? kTicks - 1 - slot : slot; }
+    static size_t rankSlot(size_t rank) { return S == Side::Buy ? kTicks - 1 - rank : rank; }
+
+    void account(Price price, Quantity delta)
+    {
+        if (!inWindow(price)) return;
+        const size_t r = rank(price - base_);
+        depth_.add(r / kBlock, delta, delta * r);
+    }
+
+    // Calls f(rank, level) for the levels of one depth block, best first,
+    // while it returns true
+    template <typename F>
+    void walkBlock(size_t block, F&& f) const
+    {
+        const size_t w = S == Side::Buy ? kBlocks - 1 - block : block;
+        for (uint64_t bits = bitmap_.word(w); bits != 0;)
+        {
+            size_t bit;
+            if constexpr (S == Side::Buy)
+            {
+                bit = 63 - std::countl_zero(bits);
+                bits &= ~(uint64_t(1) << bit);
+            }
+            else
+            {
+                bit = std::countr_zero(bits);
+                bits &= bits - 1;
+            }
+            const size_t slot = w * kBlock + bit;
+            if (!f(rank(slot), levels_[slot])) return;
+        }
+    }
+
+    double notional(const DepthIndex::Sum& sum) const
+    {
+        // weighted = sum of rank * quantity, and price = base_ + rankSlot(rank)
+        if (S == Side::Buy) return double(base_ + kTicks - 1) * double(sum.quantity) - double(sum.weighted);
+        return double(base_) * double(sum.quantity) + double(sum.weighted);
+    }
+
+    bool inWindow(Price price) const { return price >= base_ && price - base_ < kTicks; }
+
+    void recentre(Price price)
+    {
+        // nothing is set, so the array and bitmap are clean for any base
+        base_ = price > kTicks / 2 ? price - kTicks / 2 : 0;
+    }
+
+    size_t nextSlot(Price from) const
+    {
+        if constexpr (S == Side::Buy)
+        {
+            if (from < base_) return PriceBitmap::kNone;
+            return bitmap_.prev(std::min<Price>(from - base_, kTicks - 1));
+        }
+        else
+        {
+            if (from >= base_ && from - base_ >= kTicks) return PriceBitmap::kNone;
+            return bitmap_.next(from < base_ ? 0 : from - base_);
+        }
+    }
+
+    HugePageArray<PriceLevel> levels_;  // zero-filled pages are empty levels
+    PriceBitmap bitmap_;
+    DepthIndex depth_;
+    Price base_ = 0;
+    size_t levelCount_ = 0;
+
+    NodeArena overflowArena_;
+    std::map<Price, PriceLevel, Better, OverflowAllocator> overflow_{OverflowAllocator(&overflowArena_)};
+};
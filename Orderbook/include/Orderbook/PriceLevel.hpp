@@ -0,0 +1,47 @@
+#pragma once
+#include <cstdint>
+
+#include "Order.hpp"
+
+// FIFO queue of the resting orders at one price, linked through the
+// orders themselves (Order::prev_/next_), so queueing an order never
+// allocates and cancelling one is O(1). Tracks the level's open volume;
+// fills against the front order are subtracted by the matcher.
+class PriceLevel
+{
+public:
+    Quantity volume = 0;
+
+    bool empty() const { return head_ == nullptr; }
+    uint32_t count() const { return count_; }
+    Order* front() const { return head_; }
+
+    void push_back(Order* order)
+    {
+        order->prev_ = tail_;
+        order->next_ = nullptr;
+        if (tail_) tail_->next_ = order;
+        else head_ = order;
+        tail_ = order;
+        volume += order->getQuantity();
+        ++count_;
+    }
+
+    void pop_front() { erase(head_); }
+
+    void erase(Order* order)
+    {
+        if (order->prev_) order->prev_->next_ = order->next_;
+        else head_ = order->next_;
+        if (order->next_) order->next_->prev_ = order->prev_;
+        else tail_ = order->prev_;
+        order->prev_ = order->next_ = nullptr;
+        volume -= order->getQuantity();
+        --count_;
+    }
+
+private:
+    Order* head_ = nullptr;
+    Order* tail_ = nullptr;
+    uint32_t count_ = 0;
+};
@@ -3,19 +3,25 @@
 #include <utility>
 #include <stdexcept>
 #include <memory>
+#include <type_traits>
 #include <immintrin.h>
 
+#include "HugePageArray.hpp"
+
 template <typename T>
 class RingBuffer
 {
 private:
+    // Slots are used straight from zeroed pages (written == false), never
+    // constructed, so the ring costs nothing to create at any capacity
     struct alignas(64) Slot
     {
         std::atomic<bool> written{false};
         T data;
     };
+    static_assert(std::is_trivially_copyable_v<T>);
 
-    std::unique_ptr<Slot[]> buffer_;
+    HugePageArray<Slot> buffer_;
 
     // BITMASK
     const size_t capacity_;
@@ -24,17 +30,25 @@ private:
     alignas(64) std::atomic<size_t> head_{0};
     alignas(64) size_t tail_{0};
 
-public:
-
-    RingBuffer(size_t capacity) : capacity_(capacity), mask_(capacity-1)
+    static size_t checkCapacity(size_t capacity)
     {
         if ((capacity & (capacity - 1)) != 0)
         {
             throw std::runtime_error("RingBuffer capacity must be power of 2");
         }
-        buffer_ = std::make_unique<Slot[]>(capacity);
+        return capacity;
     }
 
+public:
+
+    RingBuffer(size_t capacity, int numaNode = -1)
+        : buffer_(checkCapacity(capacity), numaNode), capacity_(capacity), mask_(capacity-1)
+    {
+    }
+
+    // Faults the whole ring in now instead of on first use
+    void prefault(size_t threads = 1) { buffer_.prefault(threads); }
+
     void push(T&& item)
     {
         size_t headIdx = head_.fetch_add(1, std::memory_order_relaxed);
@@ -0,0 +1,52 @@
+#pragma once
+#include <atomic>
+#include <cerrno>
+#include <climits>
+#include <cstdint>
+#include <ctime>
+
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+// Futex-backed wake-up word for a worker thread. Producers (typically the
+// matching thread) call notify(); the worker samples prepare(), checks its
+// queues, and only then calls wait() with the sampled value, so a notify
+// that lands in between is never lost. notify() skips the syscall entirely
+// while nobody is asleep.
+class EventSignal {
+ public:
+  uint32_t prepare() const { return seq_.load(std::memory_order_acquire); }
+
+  void notify() {
+    seq_.fetch_add(1, std::memory_order_seq_cst);
+    if (sleepers_.load(std::memory_order_seq_cst) != 0) {
+      syscall(SYS_futex, reinterpret_cast<uint32_t*>(&seq_), FUTEX_WAKE_PRIVATE,
+              INT_MAX, nullptr, nullptr, 0);
+    }
+  }
+
+  // Blocks until notify() moves the word past `seen` or `timeoutNs` elapses
+  // (negative = no timeout). Spurious returns are allowed.
+  void wait(uint32_t seen, int64_t timeoutNs = -1) {
+    sleepers_.fetch_add(1, std::memory_order_seq_cst);
+    if (seq_.load(std::memory_order_seq_cst) == seen) {
+      timespec ts;
+      timespec* tsp = nullptr;
+      if (timeoutNs >= 0) {
+        ts.tv_sec = timeoutNs / 1000000000;
+        ts.tv_nsec = timeoutNs % 1000000000;
+        tsp = &ts;
+      }
+      syscall(SYS_futex, reinterpret_cast<uint32_t*>(&seq_), FUTEX_WAIT_PRIVATE,
+              seen, tsp, nullptr, 0);
+    }
+    sleepers_.fetch_sub(1, std::memory_order_seq_cst);
+  }
+
+ private:
+  static_assert(sizeof(std::atomic<uint32_t>) == sizeof(uint32_t));
+
+  alignas(64) std::atomic<uint32_t> seq_{0};
+  std::atomic<uint32_t> sleepers_{0};
+};
@@ -0,0 +1,92 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+// Hands events from one producer (the matching thread) to one consumer at
+// a time. A push is a store into a fixed ring: no lock, no allocation, and
+// never a wait on the consumer. Only if the consumer falls a whole ring
+// behind do pushes spill to a locked vector, in order, until the next
+// drain() catches up, so nothing is ever dropped.
+template <typename T>
+class SpscQueue {
+  static_assert(std::is_trivially_copyable_v<T>, "SpscQueue holds trivially copyable events");
+
+ public:
+  explicit SpscQueue(size_t capacity)
+      : buffer_(std::make_unique<T[]>(checkCapacity(capacity))),
+        capacity_(capacity),
+        mask_(capacity - 1) {}
+
+  SpscQueue(const SpscQueue&) = delete;
+  SpscQueue& operator=(const SpscQueue&) = delete;
+
+  // Producer only
+  void push(const T& item) {
+    if (!spilling_.load(std::memory_order_relaxed)) [[likely]] {
+      const size_t head = head_.load(std::memory_order_relaxed);
+      if (head - tailCache_ == capacity_) tailCache_ = tail_.load(std::memory_order_acquire);
+      if (head - tailCache_ < capacity_) {
+        buffer_[head & mask_] = item;
+        head_.store(head + 1, std::memory_order_release);
+        return;
+      }
+    }
+
+    std::lock_guard<std::mutex> lock(spillMutex_);
+    spill_.push_back(item);
+    spilling_.store(true, std::memory_order_release);
+  }
+
+  // Consumer only: calls f(item) for everything pushed so far, oldest
+  // first, and returns how many there were
+  template <typename F>
+  size_t drain(F&& f) {
+    // a spilling producer has stopped using the ring, so all of the ring
+    // is older than the spill
+    const bool spilled = spilling_.load(std::memory_order_acquire);
+
+    size_t tail = tail_.load(std::memory_order_relaxed);
+    const size_t head = head_.load(std::memory_order_acquire);
+    const size_t count = head - tail;
+    for (; tail != head; ++tail) f(buffer_[tail & mask_]);
+    tail_.store(tail, std::memory_order_release);
+    if (!spilled) return count;
+
+    {
+      std::lock_guard<std::mutex> lock(spillMutex_);
+      std::swap(spill_, draining_);
+      spilling_.store(false, std::memory_order_relaxed);
+    }
+    for (const T& item : draining_) f(item);
+    const size_t spilledCount = draining_.size();
+    draining_.clear();
+    return count + spilledCount;
+  }
+
+ private:
+  static size_t checkCapacity(size_t capacity) {
+    if (capacity == 0 || (capacity & (capacity - 1)) != 0)
+      throw std::runtime_error("SpscQueue capacity must be power of 2");
+    return capacity;
+  }
+
+  std::unique_ptr<T[]> buffer_;
+  const size_t capacity_;
+  const size_t mask_;
+
+  alignas(64) std::atomic<size_t> head_{0};
+  size_t tailCache_{0};  // producer's last look at tail_
+  alignas(64) std::atomic<size_t> tail_{0};
+
+  // Overflow path; spilling_ is set by the producer and cleared by the
+  // consumer, both under spillMutex_
+  alignas(64) std::atomic<bool> spilling_{false};
+  std::mutex spillMutex_;
+  std::vector<T> spill_;
+  std::vector<T> draining_;
+};
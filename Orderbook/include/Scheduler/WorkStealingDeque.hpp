@@ -0,0 +1,95 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <type_traits>
+
+// Fixed-capacity Chase-Lev deque (Le et al., "Correct and Efficient
+// Work-Stealing for Weak Memory Models"). The owning worker pushes and pops
+// at the bottom without contention; any other thread may steal from the top.
+// T must be trivially copyable (task indices or raw pointers).
+template <typename T>
+class WorkStealingDeque
+{
+private:
+    static_assert(std::is_trivially_copyable_v<T>, "WorkStealingDeque holds trivially copyable tasks");
+
+    std::unique_ptr<std::atomic<T>[]> buffer_;
+
+    // BITMASK
+    const int64_t capacity_;
+    const int64_t mask_;
+
+    alignas(64) std::atomic<int64_t> top_{0};
+    alignas(64) std::atomic<int64_t> bottom_{0};
+
+public:
+
+    explicit WorkStealingDeque(size_t capacity) : capacity_((int64_t)capacity), mask_((int64_t)capacity - 1)
+    {
+        if (capacity == 0 || (capacity & (capacity - 1)) != 0)
+        {
+            throw std::runtime_error("WorkStealingDeque capacity must be power of 2");
+        }
+        buffer_ = std::make_unique<std::atomic<T>[]>(capacity);
+    }
+
+    // Owner only. Returns false when the deque is full.
+    bool push(T item)
+    {
+        int64_t b = bottom_.load(std::memory_order_relaxed);
+        int64_t t = top_.load(std::memory_order_acquire);
+
+        if (b - t >= capacity_) return false;
+
+        buffer_[b & mask_].store(item, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        bottom_.store(b + 1, std::memory_order_relaxed);
+        return true;
+    }
+
+    // Owner only. LIFO end, so the most recently pushed task stays cache-hot.
+    bool pop(T& out)
+    {
+        int64_t b = bottom_.load(std::memory_order_relaxed) - 1;
+        bottom_.store(b, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t t = top_.load(std::memory_order_relaxed);
+
+        if (t > b)
+        {
+            bottom_.store(b + 1, std::memory_order_relaxed);
+            return false;
+        }
+
+        out = buffer_[b & mask_].load(std::memory_order_relaxed);
+        if (t == b)
+        {
+            // last element: race against thieves for it
+            bool won = top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+            bottom_.store(b + 1, std::memory_order_relaxed);
+            return won;
+        }
+        return true;
+    }
+
+    // Any thread. Returns false when empty or when another thief won the race.
+    bool steal(T& out)
+    {
+        int64_t t = top_.load(std::memory_order_acquire);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        int64_t b = bottom_.load(std::memory_order_acquire);
+
+        if (t >= b) return false;
+
+        out = buffer_[t & mask_].load(std::memory_order_relaxed);
+        return top_.compare_exchange_strong(t, t + 1, std::memory_order_seq_cst, std::memory_order_relaxed);
+    }
+
+    // Approximate when called concurrently; exact from the owner when idle.
+    bool empty() const
+    {
+        return bottom_.load(std::memory_order_acquire) <= top_.load(std::memory_order_acquire);
+    }
+};
@@ -0,0 +1,75 @@
+#pragma once
+#include <algorithm>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "Scheduler/WorkStealingDeque.hpp"
+#include "utils.hpp"
+
+// Runs a batch of independent, coarse-grained jobs on a fixed set of
+// threads. Jobs are dealt round-robin into per-worker deques; a worker that
+// runs dry steals from the others, so uneven job lengths still keep every
+// core busy until the batch is done.
+class WorkStealingPool {
+ public:
+  explicit WorkStealingPool(size_t threads = 0)
+      : threads_(threads ? threads
+                         : std::max<size_t>(1, std::thread::hardware_concurrency())) {}
+
+  size_t threads() const { return threads_; }
+
+  // Calls job(i) exactly once for every i in [0, jobCount) and blocks until
+  // all of them have returned.
+  template <typename Job>
+  void run(size_t jobCount, Job&& job) {
+    if (jobCount == 0) return;
+
+    const size_t workers = std::min(threads_, jobCount);
+    std::vector<std::unique_ptr<WorkStealingDeque<size_t>>> deques;
+    deques.reserve(workers);
+    for (size_t w = 0; w < workers; ++w)
+      deques.push_back(std::make_unique<WorkStealingDeque<size_t>>(nextPowerOf2(jobCount)));
+
+    // Filled before any worker starts; thread creation publishes the pushes.
+    for (size_t i = 0; i < jobCount; ++i) deques[i % workers]->push(i);
+
+    std::vector<std::thread> pool;
+    pool.reserve(workers);
+    for (size_t w = 0; w < workers; ++w) {
+      pool.emplace_back([&deques, &job, w, workers]() {
+        size_t idx;
+        while (true) {
+          if (deques[w]->pop(idx)) {
+            job(idx);
+            continue;
+          }
+
+          bool stole = false;
+          bool pending = false;
+          for (size_t k = 1; k < workers && !stole; ++k) {
+            auto& victim = *deques[(w + k) % workers];
+            if (victim.steal(idx)) {
+              stole = true;
+            } else if (!victim.empty()) {
+              pending = true;  // lost a race, work remains
+            }
+          }
+
+          if (stole) {
+            job(idx);
+          } else if (!pending) {
+            return;  // nothing is ever pushed after start: batch is drained
+          } else {
+            std::this_thread::yield();
+          }
+        }
+      });
+    }
+
+    for (auto& th : pool) th.join();
+  }
+
+ private:
+  size_t threads_;
+};
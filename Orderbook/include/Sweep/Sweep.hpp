@@ -0,0 +1,56 @@
+#pragma once
+#include <cstdint>
+#include <ostream>
+#include <vector>
+
+#include "Trader/NoiseTrader.hpp"
+
+/* -------------------------------------------------------------------------- */
+/*                              Parameter sweep                               */
+/* -------------------------------------------------------------------------- */
+
+// One simulation: a population mix and NoiseTrader parameters, driven for a
+// fixed number of rounds on an inline (single-threaded) book. Identical
+// points always produce identical results.
+struct SweepPoint {
+  int noiseTraders = 10;
+  int whaleTraders = 0;
+  int momentumTraders = 0;
+  NoiseTraderParams noise{};
+  uint64_t seed = 1;
+  size_t rounds = 10000;
+  size_t maxOrders = 0;  // 0 = sized from the population
+};
+
+// Grid axes; the sweep is their cartesian product.
+struct SweepGrid {
+  std::vector<int> noiseTraders{10};
+  std::vector<int> whaleTraders{0};
+  std::vector<int> momentumTraders{0};
+  std::vector<int> priceSpread{Config::nPSpread};
+  std::vector<int> qtySpread{Config::nQSpread};
+  std::vector<int> makerP{Config::makerP};
+  std::vector<uint64_t> seeds{1};
+  size_t rounds = 10000;
+  size_t maxOrders = 0;
+};
+
+struct SweepResult {
+  SweepPoint point;
+  uint64_t trades = 0;
+  uint64_t volume = 0;
+  double avgSpread = 0;  // mean of (topAsk - topBid) over two-sided rounds
+  size_t restingOrders = 0;
+  double runtimeMs = 0;
+};
+
+std::vector<SweepPoint> expandGrid(const SweepGrid& grid);
+
+SweepResult runSimulation(const SweepPoint& point);
+
+// Runs every point concurrently on a work-stealing pool (0 = all cores).
+// Results are returned in the order of `points`.
+std::vector<SweepResult> runSweep(const std::vector<SweepPoint>& points,
+                                  size_t threads = 0);
+
+void writeCsv(std::ostream& out, const std::vector<SweepResult>& results);
@@ -0,0 +1,63 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+
+#include "Trader/CoTrader.hpp"
+#include "Trader/OrderIdAllocator.hpp"
+#include "Orderbook/Orderbook.hpp"
+
+// Runs CoTrader coroutines on a small set of (optionally pinned) worker
+// threads. The scheduler installs the book's trade, ack and quote listeners
+// and turns them into wake-ups: fills and cancel acks are posted to the
+// owning worker's inbox, quote changes bump a sequence number, and timers
+// live in a per-worker heap. A worker with nothing runnable sleeps on a
+// futex until one of those fires, so idle agents cost no CPU.
+//
+// Agents are pinned to a worker (id order, round robin) for their lifetime.
+// Like TraderManager, a scheduler owns the book's listeners: do not drive
+// the same book from both.
+class CoScheduler {
+ public:
+  // workers = 0 uses every core; firstCore >= 0 pins worker w to firstCore + w
+  explicit CoScheduler(Orderbook& ob, size_t workers = 0, int firstCore = -1);
+  ~CoScheduler();
+
+  // Register before start()
+  void spawn(std::shared_ptr<CoTrader> agent);
+
+  void start();
+  void stop();
+  void join();
+
+  // From the caller's own block lease, see OrderIdAllocator
+  OrderId nextOrderId(OrderIdAllocator::Lease& lease) { return orderIds_.next(lease); }
+
+  // Total coroutine resumptions across all workers
+  uint64_t resumes() const;
+
+ private:
+  friend class CoTrader;
+
+  void workerLoop(CoWorker& w);
+  void post(CoTrader* agent, const CoEvent& e);
+  CoTrader* agentFor(uint32_t owner) const {
+    return owner < byOwner_.size() ? byOwner_[owner] : nullptr;
+  }
+
+  Orderbook& ob_;
+  std::vector<std::unique_ptr<CoWorker>> workers_;
+  std::vector<std::shared_ptr<CoTrader>> agents_;
+  std::vector<CoTrader*> byOwner_;
+  std::vector<std::thread> threads_;
+  std::atomic<bool> running_;
+  OrderIdAllocator orderIds_;
+  int firstCore_;
+
+  // Latest top of book, published by the quote listener
+  std::atomic<uint64_t> quoteSeq_{0};
+  std::atomic<Price> quoteBid_{0};
+  std::atomic<Price> quoteAsk_{0};
+};
@@ -0,0 +1,188 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <coroutine>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <utility>
+
+#include "Constants.hpp"
+#include "Orderbook/Orderbook.hpp"
+#include "Trader/OrderIdAllocator.hpp"
+
+class CoScheduler;
+class CoTrader;
+struct CoWorker;
+
+/* -------------------------------------------------------------------------- */
+/*                               Coroutine task                               */
+/* -------------------------------------------------------------------------- */
+
+// Return type of CoTrader::run(). Starts suspended and never resumes itself;
+// the scheduler owns every resumption and destroys the frame with the task.
+class CoTask {
+ public:
+  struct promise_type {
+    CoTask get_return_object() {
+      return CoTask(std::coroutine_handle<promise_type>::from_promise(*this));
+    }
+    std::suspend_always initial_suspend() noexcept { return {}; }
+    std::suspend_always final_suspend() noexcept { return {}; }
+    void return_void() {}
+    void unhandled_exception() { std::terminate(); }
+  };
+
+  CoTask() = default;
+  explicit CoTask(std::coroutine_handle<promise_type> h) : handle_(h) {}
+  CoTask(CoTask&& other) noexcept : handle_(std::exchange(other.handle_, nullptr)) {}
+  CoTask& operator=(CoTask&& other) noexcept {
+    if (this != &other) {
+      reset();
+      handle_ = std::exchange(other.handle_, nullptr);
+    }
+    return *this;
+  }
+  CoTask(const CoTask&) = delete;
+  CoTask& operator=(const CoTask&) = delete;
+  ~CoTask() { reset(); }
+
+  bool done() const { return !handle_ || handle_.done(); }
+  void resume() const { handle_.resume(); }
+
+ private:
+  void reset() {
+    if (handle_) handle_.destroy();
+    handle_ = nullptr;
+  }
+
+  std::coroutine_handle<promise_type> handle_;
+};
+
+// Execution on one of the agent's own orders
+struct Fill {
+  OrderId orderId;
+  Side side;
+  Price price;
+  Quantity qty;
+};
+
+// Engine event routed to the worker that owns an agent
+struct CoEvent {
+  CoTrader* agent;
+  bool isFill;
+  Fill fill;    // isFill
+  AckType ack;  // !isFill, fill.orderId names the order
+};
+
+/* -------------------------------------------------------------------------- */
+/*                               Coroutine trader                             */
+/* -------------------------------------------------------------------------- */
+
+// Agent whose logic is a single coroutine. Instead of being polled through
+// tick(), it co_awaits the engine events it cares about and costs nothing
+// while it waits:
+//
+//   CoTask run() override {
+//     while (isRunning()) {
+//       Quote q = co_await nextQuote();
+//       OrderId id = placeOrder(OrderType::GoodTillCancel, q.bid, 1, Side::Buy);
+//       co_await sleepFor(std::chrono::milliseconds(5));
+//       cancelOrder(id);
+//       co_await cancelAck(id);
+//     }
+//   }
+//
+// Awaitables may only be used directly inside run(); nested coroutines are
+// not supported.
+class CoTrader {
+ public:
+  CoTrader(uint32_t id, int64_t cash, Orderbook& ob)
+      : traderId_(id), isRunning_(true), cash_(cash), ob_(ob) {}
+
+  virtual ~CoTrader() = default;
+
+  virtual CoTask run() = 0;
+
+  /* ----------------------------- Getters & Setters ------------------- */
+  uint32_t getId() const { return traderId_; }
+  bool isRunning() const { return isRunning_.load(); }
+  void stop() { isRunning_ = false; }
+
+  // Worker-owned; only read these once the scheduler has been joined
+  int64_t cash() const { return cash_; }
+  int64_t stock() const { return stock_; }
+
+ protected:
+  struct QuoteAwaiter {
+    CoTrader* self;
+    bool await_ready() const noexcept { return false; }
+    void await_suspend(std::coroutine_handle<>);
+    Quote await_resume() const noexcept { return self->quote_; }
+  };
+
+  struct FillAwaiter {
+    CoTrader* self;
+    bool await_ready() const noexcept { return !self->fills_.empty(); }
+    void await_suspend(std::coroutine_handle<>);
+    Fill await_resume();
+  };
+
+  struct AckAwaiter {
+    CoTrader* self;
+    OrderId orderId;
+    bool await_ready() const noexcept;
+    void await_suspend(std::coroutine_handle<>);
+    AckType await_resume();
+  };
+
+  struct TimerAwaiter {
+    CoTrader* self;
+    std::chrono::nanoseconds delay;
+    bool await_ready() const noexcept { return delay.count() <= 0; }
+    void await_suspend(std::coroutine_handle<>);
+    void await_resume() const noexcept {}
+  };
+
+  // Resumes on the next top-of-book change
+  QuoteAwaiter nextQuote() { return {this}; }
+  // Resumes with the oldest unconsumed fill on any of this agent's orders
+  FillAwaiter nextFill() { return {this}; }
+  // Resumes with Cancelled (or Rejected if the order was already gone)
+  AckAwaiter cancelAck(OrderId id) { return {this, id}; }
+  TimerAwaiter sleepFor(std::chrono::nanoseconds delay) { return {this, delay}; }
+
+  const Quote& lastQuote() const { return quote_; }
+
+  // Convenience helpers for derived traders
+  OrderId placeOrder(OrderType type, Price price, Quantity qty, Side side);
+  void cancelOrder(OrderId id);
+
+ private:
+  friend class CoScheduler;
+
+  enum struct Wait : uint8_t { None, Quote, Fill, Ack, Timer };
+
+  static constexpr size_t maxPendingEvents = 1024;
+
+  // Applies an event on the owning worker; returns true if it satisfies
+  // what the coroutine is currently suspended on.
+  bool deliver(const CoEvent& e);
+
+  uint32_t traderId_;
+  std::atomic<bool> isRunning_;
+  int64_t cash_;
+  int64_t stock_{0};
+  Orderbook& ob_;
+
+  CoScheduler* scheduler_{nullptr};
+  OrderIdAllocator::Lease idLease_;  // ids stay monotonic per agent
+  CoWorker* worker_{nullptr};
+  CoTask task_;
+
+  Wait waiting_{Wait::None};
+  OrderId waitId_{0};
+  Quote quote_{0, 0};
+  std::deque<Fill> fills_;
+  std::deque<std::pair<OrderId, AckType>> acks_;
+};
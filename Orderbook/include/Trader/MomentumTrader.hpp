@@ -0,0 +1,83 @@
+#pragma once
+
+#include "Config.hpp"
+#include "Trader.hpp"
+
+// Runtime knobs for MomentumTrader; defaults come from Config
+struct MomentumTraderParams {
+  int shortWindow = Config::mShortWindow;
+  int longWindow = Config::mLongWindow;
+  Quantity qty = Config::mQty;
+  int aggression = Config::mAggression;
+};
+
+// Trend follower fed by the engine's trade stream. It keeps a fast and a
+// slow EMA of print prices (O(1) per print, no history) and fires a
+// FillAndKill `aggression` levels through the touch whenever the fast EMA
+// crosses the slow one. It never polls: it is ticked only when trades
+// print, so a population of them reacts to the same print at once, which
+// is what produces correlated bursts of aggressive flow.
+class MomentumTrader : public Trader {
+ public:
+  MomentumTrader(uint32_t id, uint64_t cash, Orderbook& ob,
+                 MomentumTraderParams params = {})
+      : Trader(id, cash, Strategy::Momentum, ob),
+        params_(params),
+        shortAlpha_(2.0 / (params.shortWindow + 1)),
+        longAlpha_(2.0 / (params.longWindow + 1)) {
+    subscribe(WakeOnTrade);
+    setTimer(0);
+  }
+
+  void tick() override {
+    readTrades([this](const Print& p) { update(double(p.price)); });
+    if (prints_ < uint64_t(params_.longWindow)) return;  // warming up
+
+    int trend = shortEma_ > longEma_ ? 1 : (shortEma_ < longEma_ ? -1 : 0);
+    if (trend == 0 || trend == trend_) return;
+
+    // the first trend after warm-up only sets the baseline
+    bool cross = trend_ != 0;
+    trend_ = trend;
+    if (cross) fire(trend > 0 ? Side::Buy : Side::Sell);
+  }
+
+  // Worker-owned; read once the manager has been joined
+  double shortEma() const { return shortEma_; }
+  double longEma() const { return longEma_; }
+  uint64_t signals() const { return signals_; }
+
+ private:
+  void update(double price) {
+    if (prints_++ == 0) {
+      shortEma_ = longEma_ = price;
+      return;
+    }
+    shortEma_ += shortAlpha_ * (price - shortEma_);
+    longEma_ += longAlpha_ * (price - longEma_);
+  }
+
+  void fire(Side side) {
+    Price limit;
+    if (side == Side::Buy) {
+      Price ta = ob_.topAskPrice();
+      if (ta == 0) return;
+      limit = ta + params_.aggression;
+    } else {
+      Price tb = ob_.topBidPrice();
+      if (tb == 0) return;
+      limit = tb > Price(params_.aggression) ? tb - params_.aggression : 1;
+    }
+    placeOrder(OrderType::FillAndKill, limit, params_.qty, side);
+    ++signals_;
+  }
+
+  MomentumTraderParams params_;
+  double shortAlpha_;
+  double longAlpha_;
+  double shortEma_ = 0;
+  double longEma_ = 0;
+  uint64_t prints_ = 0;
+  int trend_ = 0;
+  uint64_t signals_ = 0;
+};
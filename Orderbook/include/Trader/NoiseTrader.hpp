@@ -2,44 +2,57 @@
 
 #include "Trader.hpp"
 #include "Config.hpp"
+#include "utils.hpp"
 #include <random>
 
+// Runtime knobs for NoiseTrader; defaults mirror Config so the simulation
+// binaries behave as before, while the sweep can vary them per run.
+struct NoiseTraderParams {
+  int priceSpread = Config::nPSpread;
+  int qtySpread = Config::nQSpread;
+  int makerP = Config::makerP;
+};
+
 class NoiseTrader : public Trader {
  public:
-  NoiseTrader(uint32_t id, uint64_t cash, Orderbook& ob)
-      : Trader(id, cash, Strategy::Noise, ob) {}
+  NoiseTrader(uint32_t id, uint64_t cash, Orderbook& ob,
+              NoiseTraderParams params = {},
+              uint64_t seed = std::random_device{}())
+      : Trader(id, cash, Strategy::Noise, ob),
+        params_(params),
+        gen_(seed ^ (uint64_t(id) << 32)),
+        offsetDist_(-params.priceSpread, params.priceSpread),
+        qtyDist_(1, params.qtySpread) {}
 
   void tick() override {
-    static thread_local std::mt19937_64 gen(std::random_device{}());
-    static thread_local std::uniform_int_distribution<int> actionDist(0, 99);
-    static thread_local std::uniform_int_distribution<int> sideDist(0, 100);
-    static thread_local std::uniform_int_distribution<int> offsetDist(-Config::nPSpread, Config::nPSpread);
-    static thread_local std::uniform_int_distribution<Quantity> qtyDist(1, Config::nQSpread);
-
-    int act = actionDist(gen);
+    int act = int(gen_() % 100);
 
     if (!orders_.empty() && act < 5) {
-      // use modulo instead of constructing a distribution each tick
-      size_t idx = gen() % orders_.size();
-      cancelOrder(orders_[idx]);
+      cancelOrder(orders_.pick(gen_()));
       return;
     }
 
     if (orders_.size() < (size_t)Config::maxOrdersPerTrader && act < 50) {
-      Side s = (sideDist(gen) < Config::makerP) ? Side::Buy : Side::Sell;
+      Side s = (int(gen_() % 101) < params_.makerP) ? Side::Buy : Side::Sell;
 
       Price base = 100;
       Price tb = ob_.topBidPrice();
       Price ta = ob_.topAskPrice();
       if (tb != 0 && ta != 0) base = (tb + ta) / 2;
 
-      int offset = offsetDist(gen);
+      int offset = offsetDist_(gen_);
       Price price = (offset < 0 && base <= (Price)(-offset)) ? 1 : base + offset;
       if (price == 0) price = 1;
 
-      Quantity qty = qtyDist(gen);
+      Quantity qty = qtyDist_(gen_);
 
       placeOrder(OrderType::GoodTillCancel, price, qty, s);
     }
   }
+
+ private:
+  NoiseTraderParams params_;
+  SplitMix64 gen_;  // per-trader stream: deterministic for a given seed
+  std::uniform_int_distribution<int> offsetDist_;
+  std::uniform_int_distribution<Quantity> qtyDist_;
 };
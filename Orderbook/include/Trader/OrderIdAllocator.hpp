@@ -0,0 +1,44 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+
+#include "Config.hpp"
+#include "Constants.hpp"
+
+// Hands out OrderIds without touching a shared cache line per order. Each
+// producer (a trader, whichever worker happens to tick it) owns a Lease: a
+// block of `block` consecutive ids taken from the shared counter, which it
+// then counts through locally. Ids are unique, increase monotonically per
+// lease, and stay dense (1, 2, 3, ... with at most one partially used
+// block per lease as a gap), which keeps them usable as indices into a
+// direct-mapped order table.
+class OrderIdAllocator {
+ public:
+  // One producer's block. A lease may only be used by one thread at a time.
+  struct Lease {
+    uint64_t epoch = 0;
+    OrderId next = 0;
+    OrderId end = 0;
+  };
+
+  explicit OrderIdAllocator(OrderId first = 1, OrderId block = Config::orderIdBlock)
+      : epoch_(instances_.fetch_add(1) + 1), block_(block), next_(first) {}
+
+  OrderId next(Lease& lease) {
+    // the epoch tells allocators (even ones reusing a dead allocator's
+    // address) apart, so a lease carried over starts a fresh block
+    if (lease.epoch != epoch_ || lease.next == lease.end) {
+      lease.epoch = epoch_;
+      lease.next = next_.fetch_add(block_, std::memory_order_relaxed);
+      lease.end = lease.next + block_;
+    }
+    return lease.next++;
+  }
+
+ private:
+  static inline std::atomic<uint64_t> instances_{0};
+
+  const uint64_t epoch_;
+  const OrderId block_;
+  std::atomic<OrderId> next_;
+};
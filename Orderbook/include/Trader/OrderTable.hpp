@@ -0,0 +1,125 @@
+#pragma once
+#include <cstdint>
+#include <memory>
+
+#include "Constants.hpp"
+
+/* -------------------------------------------------------------------------- */
+/*                           Trader-side order state                          */
+/* -------------------------------------------------------------------------- */
+
+//   Pending --Accepted--> Live --fill--> PartiallyFilled --fill--> Filled
+//      |                   |                  |
+//      +-------------------+------------------+--Cancelled/Rejected--> Cancelled
+//
+// Filled and Cancelled are terminal: the entry is dropped from the table.
+enum struct OrderState : uint8_t { Pending, Live, PartiallyFilled, Filled, Cancelled };
+
+struct TrackedOrder {
+  OrderId id;  // 0 marks an empty slot
+  Price price;
+  Quantity qty;
+  Quantity filled;
+  Side side;
+  OrderState state;
+  bool cancelSent;
+
+  // A modify keeps the id, so reports for the replaced incarnation can
+  // still arrive after it: `stale` of its quantity (still reserved, at
+  // `stalePrice`) may yet fill, and `staleAcks` acks are due before the
+  // new incarnation's own
+  Price stalePrice;
+  Quantity stale;
+  Side staleSide;
+  uint8_t staleAcks;
+
+  Quantity remaining() const { return qty - filled; }
+};
+
+// Engine execution report queued for a trader (fill or ack)
+struct ExecReport {
+  OrderId orderId;
+  Quantity qty;  // fills only
+  Price price;   // fills only: the filled order's own limit
+  AckType ack;
+  bool isFill;
+};
+
+// Flat open-addressing map OrderId -> TrackedOrder (linear probing,
+// backward-shift deletion, no tombstones). One contiguous allocation that
+// only changes when the table doubles, so tracking a trader's working
+// orders costs no allocation per order.
+class OrderTable {
+ public:
+  explicit OrderTable(size_t capacity = 16) { rehash(capacity); }
+
+  size_t size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+
+  TrackedOrder* find(OrderId id) {
+    for (size_t i = slot(id);; i = (i + 1) & mask_) {
+      if (slots_[i].id == id) return &slots_[i];
+      if (slots_[i].id == 0) return nullptr;
+    }
+  }
+
+  TrackedOrder& insert(const TrackedOrder& order) {
+    if ((size_ + 1) * 2 > capacity_) rehash(capacity_ * 2);
+    size_t i = slot(order.id);
+    while (slots_[i].id != 0 && slots_[i].id != order.id) i = (i + 1) & mask_;
+    if (slots_[i].id == 0) ++size_;
+    slots_[i] = order;
+    return slots_[i];
+  }
+
+  bool erase(OrderId id) {
+    size_t i = slot(id);
+    while (slots_[i].id != id) {
+      if (slots_[i].id == 0) return false;
+      i = (i + 1) & mask_;
+    }
+
+    // shift later members of the probe run back into the hole
+    size_t hole = i;
+    for (size_t j = (hole + 1) & mask_; slots_[j].id != 0; j = (j + 1) & mask_) {
+      size_t home = slot(slots_[j].id);
+      if (((j - home) & mask_) >= ((j - hole) & mask_)) {
+        slots_[hole] = slots_[j];
+        hole = j;
+      }
+    }
+    slots_[hole].id = 0;
+    --size_;
+    return true;
+  }
+
+  // Some tracked order, chosen by `r` (e.g. a random number); 0 if empty
+  OrderId pick(uint64_t r) const {
+    if (size_ == 0) return 0;
+    for (size_t i = r & mask_;; i = (i + 1) & mask_)
+      if (slots_[i].id != 0) return slots_[i].id;
+  }
+
+ private:
+  size_t slot(OrderId id) const {
+    return (size_t)((id * 0x9e3779b97f4a7c15ULL) >> 32) & mask_;
+  }
+
+  void rehash(size_t capacity) {
+    std::unique_ptr<TrackedOrder[]> old = std::move(slots_);
+    size_t oldCapacity = old ? capacity_ : 0;
+
+    capacity_ = capacity;
+    mask_ = capacity - 1;
+    size_ = 0;
+    slots_ = std::make_unique<TrackedOrder[]>(capacity);  // value-init: id 0
+
+    for (size_t i = 0; i < oldCapacity; ++i)
+      if (old[i].id != 0) insert(old[i]);
+  }
+
+  std::unique_ptr<TrackedOrder[]> slots_;
+  size_t capacity_{0};
+  size_t mask_{0};
+  size_t size_{0};
+};
@@ -0,0 +1,61 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+// Flat owner-id -> T* table for routing engine events on the matching
+// thread. Owner ids are small dense integers, so a lookup is one bounds
+// check and one indexed load: no hashing, no refcounts.
+//
+// A single registering thread may grow the table while readers are active:
+// growth copies into a larger table and publishes it atomically, and
+// superseded tables stay alive until the registry is destroyed so a reader
+// holding an old one is never left dangling.
+template <typename T>
+class OwnerRegistry {
+ public:
+  explicit OwnerRegistry(size_t capacity = 64) { grow(capacity); }
+
+  T* find(uint32_t owner) const {
+    const Table* table = current_.load(std::memory_order_acquire);
+    if (owner >= table->size) return nullptr;
+    return table->slots[owner].load(std::memory_order_acquire);
+  }
+
+  // Registration thread only
+  void set(uint32_t owner, T* value) {
+    const Table* table = current_.load(std::memory_order_relaxed);
+    if (owner >= table->size) {
+      grow(std::max<size_t>(size_t(owner) + 1, table->size * 2));
+      table = current_.load(std::memory_order_relaxed);
+    }
+    table->slots[owner].store(value, std::memory_order_release);
+  }
+
+ private:
+  struct Table {
+    size_t size;
+    std::unique_ptr<std::atomic<T*>[]> slots;
+  };
+
+  void grow(size_t capacity) {
+    auto table = std::make_unique<Table>();
+    table->size = capacity;
+    table->slots = std::make_unique<std::atomic<T*>[]>(capacity);
+
+    if (!tables_.empty()) {
+      const Table& old = *tables_.back();
+      for (size_t i = 0; i < old.size; ++i)
+        table->slots[i].store(old.slots[i].load(std::memory_order_relaxed),
+                              std::memory_order_relaxed);
+    }
+
+    current_.store(table.get(), std::memory_order_release);
+    tables_.push_back(std::move(table));
+  }
+
+  std::atomic<const Table*> current_{nullptr};
+  std::vector<std::unique_ptr<Table>> tables_;  // every table ever published
+};
@@ -0,0 +1,76 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <memory>
+
+#include "Config.hpp"
+#include "Constants.hpp"
+
+// One printed trade as seen by market-data consumers
+struct Print {
+  Price price;
+  Quantity qty;
+};
+
+// Fixed-size broadcast ring of recent prints. The matching thread is the
+// only writer; any number of traders read it with a private cursor, so a
+// trade is published once no matter how many agents consume it. Readers
+// that fall more than `capacity` prints behind skip what was overwritten.
+// Each slot carries the sequence number it holds, which lets a reader
+// detect (and drop) a slot the writer recycled while it was being read.
+class TradeTape {
+ public:
+  explicit TradeTape(size_t capacity = Config::tradeTapeSize)
+      : mask_(capacity - 1), slots_(std::make_unique<Slot[]>(capacity)) {
+    for (size_t i = 0; i < capacity; ++i) slots_[i].seq.store(kEmpty, std::memory_order_relaxed);
+  }
+
+  // Writer (matching thread) only
+  void append(Price price, Quantity qty) {
+    uint64_t s = head_.load(std::memory_order_relaxed);
+    Slot& slot = slots_[s & mask_];
+    slot.seq.store(kEmpty, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.price.store(price, std::memory_order_relaxed);
+    slot.qty.store(qty, std::memory_order_relaxed);
+    slot.seq.store(s, std::memory_order_release);
+    head_.store(s + 1, std::memory_order_release);
+  }
+
+  // Sequence number of the next print
+  uint64_t head() const { return head_.load(std::memory_order_acquire); }
+
+  // Delivers prints in [cursor, head) oldest first and advances cursor;
+  // returns how many were delivered
+  template <typename F>
+  size_t read(uint64_t& cursor, F&& onPrint) const {
+    const uint64_t h = head();
+    if (h - cursor > mask_ + 1) cursor = h - (mask_ + 1);
+
+    size_t delivered = 0;
+    for (; cursor < h; ++cursor) {
+      const Slot& slot = slots_[cursor & mask_];
+      if (slot.seq.load(std::memory_order_acquire) != cursor) continue;
+      Print p{slot.price.load(std::memory_order_relaxed),
+              slot.qty.load(std::memory_order_relaxed)};
+      std::atomic_thread_fence(std::memory_order_acquire);
+      if (slot.seq.load(std::memory_order_relaxed) != cursor) continue;  // recycled
+      onPrint(p);
+      ++delivered;
+    }
+    return delivered;
+  }
+
+ private:
+  static constexpr uint64_t kEmpty = ~uint64_t(0);
+
+  struct Slot {
+    std::atomic<uint64_t> seq;
+    std::atomic<Price> price;
+    std::atomic<Quantity> qty;
+  };
+
+  alignas(64) std::atomic<uint64_t> head_{0};
+  size_t mask_;
+  std::unique_ptr<Slot[]> slots_;
+};
@@ -1,12 +1,22 @@
 #pragma once
 #include <atomic>
-#include <vector>
-#include <unordered_map>
 
 #include "Constants.hpp"
 #include "Orderbook/Orderbook.hpp"
+#include "Scheduler/SpscQueue.hpp"
+#include "Trader/OrderIdAllocator.hpp"
+#include "Trader/OrderTable.hpp"
+#include "Trader/TradeTape.hpp"
 
 class TraderManager;  // forward
+struct TraderWorker;
+
+// Engine events that make TraderManager tick a trader (bitmask)
+enum WakeEvent : uint8_t {
+  WakeOnQuote = 1 << 0,  // top of book changed
+  WakeOnFill = 1 << 1,   // one of this trader's orders traded
+  WakeOnTrade = 1 << 2,  // any trade printed (market data)
+};
 
 class Trader {
  public:
@@ -29,21 +39,57 @@ class Trader {
 
   virtual void tick() = 0;
 
+  uint8_t wakeEvents() const { return wakeOn_; }
+  int64_t timerUs() const { return timerUs_; }
+
+  // Called on the matching thread: settle cash/stock immediately and queue
+  // the execution report for the order table (applied before the next tick)
   inline void onTrade(Trade& t) {
     if (t.bid->getOwner() == traderId_) {
       stock_ += t.qty;
-      reservedCash_ -= t.ask->getPrice() * t.qty;
-    } else if (t.ask->getOwner() == traderId_) {
+      cash_ -= t.price * t.qty;
+      // at the order's own limit, which is what placeOrder() reserved
+      reservedCash_ -= t.bid->getPrice() * t.qty;
+      postReport({t.bid->getOrderId(), t.qty, t.bid->getPrice(), AckType::Accepted, true});
+    }
+    if (t.ask->getOwner() == traderId_) {
       reservedStock_ -= t.qty;
-      cash_ += t.bid->getPrice() * t.qty;
+      cash_ += t.price * t.qty;
+      postReport({t.ask->getOrderId(), t.qty, t.ask->getPrice(), AckType::Accepted, true});
     }
   }
 
+  inline void onAck(Ack& ack) { postReport({ack.orderId, 0, 0, ack.type, false}); }
+
+  // Drive the order state machine with everything reported since the last
+  // call. Runs on the thread that ticks the trader, right before tick().
+  void applyReports();
+
+  size_t workingOrders() const { return orders_.size(); }
+
  protected:
-  // Convenience helpers for derived traders
+  // Subscriptions are read when the trader is added to a manager, so set
+  // them from the constructor. A trader is ticked when any subscribed event
+  // fires and, if a timer is set, at least every `timerUs` microseconds.
+  // By default there are no event subscriptions and the timer is the
+  // manager's poll interval, which reproduces plain polling.
+  void subscribe(uint8_t events) { wakeOn_ = events; }
+  void setTimer(int64_t us) { timerUs_ = us; }  // 0 = no timer
+
+  // Prints since the last call, oldest first; only available once the
+  // trader has been added to a manager. Subscribe to WakeOnTrade to be
+  // ticked when there is something to read.
+  template <typename F>
+  size_t readTrades(F&& onPrint) {
+    return tape_ ? tape_->read(tapeCursor_, onPrint) : 0;
+  }
+
+  // Convenience helpers for derived traders. Cancels and modifies are only
+  // sent for orders that are still working, and a modify only once the
+  // engine has answered the previous one; they return false otherwise.
   OrderId placeOrder(OrderType type, Price price, Quantity qty, Side side);
-  void cancelOrder(OrderId id);
-  void modifyOrder(OrderId id, OrderType type, Price price, Quantity qty,
+  bool cancelOrder(OrderId id);
+  bool modifyOrder(OrderId id, OrderType type, Price price, Quantity qty,
                    Side side);
 
  protected:
@@ -59,6 +105,39 @@ class Trader {
   Strategy strategy_;
   Orderbook& ob_;
 
-  std::vector<OrderId> orders_;
-  std::unordered_map<OrderId, int> orderIndex_;
+  // Working orders only: filled and cancelled orders are dropped as soon as
+  // their execution report is applied
+  OrderTable orders_;
+
+ private:
+  friend class TraderManager;
+
+  static constexpr size_t kReportRing = 256;
+
+  void postReport(const ExecReport& report) { reports_.push(report); }
+  void applyReport(const ExecReport& report);
+
+  // Cash (buys) or stock (sells) set aside for working orders
+  void reserve(Side side, Price price, Quantity qty);
+  void release(Side side, Price price, Quantity qty);
+  void releaseStale(TrackedOrder& order);
+
+  // Written by the matching thread, drained by applyReports()
+  SpscQueue<ExecReport> reports_{kReportRing};
+
+  // Ids stay monotonic per trader whichever worker ticks it
+  OrderIdAllocator::Lease idLease_;
+
+  const TradeTape* tape_{nullptr};
+  uint64_t tapeCursor_{0};
+
+  uint8_t wakeOn_{0};
+  int64_t timerUs_{-1};  // <0: manager's poll interval
+
+  // Scheduling state, owned by TraderManager
+  std::atomic<bool> wakePending_{false};
+  Trader* nextReady_{nullptr};
+  std::atomic<uint8_t> sched_{0};  // queued / rerun bits: one tick in flight at most
+  std::atomic<int64_t> nextTimer_{0};
+  size_t worker_{0};  // home worker: owns the inbox and subscriptions
 };
\ No newline at end of file
@@ -1,84 +1,81 @@
 #pragma once
 
+#include <algorithm>
 #include <atomic>
 #include <memory>
 #include <thread>
 #include <vector>
-#include <chrono>
-#include <algorithm>
-#include <unordered_map>
 
 #include "Trader/Trader.hpp"
+#include "Trader/OrderIdAllocator.hpp"
+#include "Trader/OwnerRegistry.hpp"
 #include "Orderbook/Orderbook.hpp"
 
+// Runs traders on worker threads and ticks them only when something they
+// subscribed to happened (see Trader::subscribe) or their timer expired.
+// The book's listeners act as the dispatcher: on the matching thread they
+// mark traders ready and poke the home worker's futex, so idle workers
+// sleep instead of spinning through sleep_for.
+//
+// Every due tick is a task on the detecting worker's work-stealing deque;
+// workers that run dry steal from the others, so a few expensive traders
+// cannot leave the rest of the pool idle. A trader has at most one task in
+// flight, so its tick() never runs concurrently with itself.
 class TraderManager {
  public:
-  explicit TraderManager(Orderbook& ob, size_t sleepUs = 1000)
-      : ob_(ob), running_(false), nextOrderId_(1), sleepUs_(sleepUs) {
-    // forward trades from the orderbook to only the involved traders (O(1))
-    ob_.setTradeListener([this](Trade& t) {
-      // Bid Side onTrade()
-      auto it = tradersById_.find(t.bid->getOwner());
-      if (it != tradersById_.end()) it->second.get()->onTrade(t);
-      // Ask side onTrade()
-      auto it2 = tradersById_.find(t.ask->getOwner());
-      if (it2 != tradersById_.end() && (!t.bid || t.ask->getOwner() != t.bid->getOwner())) it2->second.get()->onTrade(t);
-    });
-  }
-
-  ~TraderManager() {
-    // unregister trade listener to avoid callbacks into a destructed manager
-    ob_.setTradeListener(nullptr);
-    stop();
-    join();
-  }
-
-  void addTrader(std::shared_ptr<Trader> t) {
-    t->setManager(this);
-    traders_.push_back(t);
-    tradersById_.emplace(t->getId(), std::move(t));
-  }
+  explicit TraderManager(Orderbook& ob, size_t sleepUs = 1000);
+  ~TraderManager();
 
-  void start() {
-    running_ = true;
+  // Register before start(); subscriptions are captured here
+  void addTrader(std::shared_ptr<Trader> t);
 
-    size_t workerCount = std::max<size_t>(1, std::thread::hardware_concurrency());
+  void start();
 
-    for (size_t w = 0; w < workerCount; ++w) {
-
-      // emplace?
-      threads_.emplace_back([this, w, workerCount]() {
-        while (running_.load()) {
-          for (size_t i = w; i < traders_.size(); i += workerCount) {
-            std::shared_ptr<Trader> t = traders_[i];
-            if (!t) continue;
-            if (!running_.load() || !t->isRunning()) break;
-            t->tick();
-          }
-          std::this_thread::sleep_for(std::chrono::microseconds(sleepUs_));
-        }
-      });
+  // Tick every running trader once on the calling thread, in registration
+  // order. Paired with an EngineMode::Inline book this gives a fully
+  // deterministic simulation without any worker threads.
+  void step() {
+    for (auto& t : traders_) {
+      if (!t->isRunning()) continue;
+      t->applyReports();
+      t->tick();
     }
   }
 
-  void stop() {
-    running_.store(false);
-    for (auto t : traders_) t->stop();
-  }
+  void stop();
+  void join();
 
-  void join() {
-    for (auto& th : threads_) if (th.joinable()) th.join();
-    threads_.clear();
-  }
+  // From the caller's own block lease, see OrderIdAllocator
+  OrderId nextOrderId(OrderIdAllocator::Lease& lease) { return orderIds_.next(lease); }
 
-  OrderId nextOrderId() { return nextOrderId_.fetch_add(1); }
+  // Total trader ticks run by the workers (ticks/sec = delta / interval)
+  uint64_t ticks() const;
 
  private:
+  void workerLoop(size_t index);
+  void wake(Trader* t);
+  void schedule(TraderWorker& w, Trader* t);
+  void runTask(TraderWorker& w, Trader* t, int64_t now);
+  bool steal(size_t thief, Trader*& out);
+  // 0 = no timer; a zero poll interval still polls back to back
+  int64_t timerNs(const Trader* t) const {
+    if (t->timerUs() >= 0) return t->timerUs() * 1000;
+    return std::max<int64_t>(1, (int64_t)sleepUs_ * 1000);
+  }
+
   Orderbook& ob_;
   std::vector<std::shared_ptr<Trader>> traders_;
-  std::unordered_map<uint32_t, std::shared_ptr<Trader>> tradersById_;
+  OwnerRegistry<Trader> tradersById_;  // fill routing on the matching thread
+  std::vector<std::unique_ptr<TraderWorker>> workers_;
   std::vector<std::thread> threads_;
   std::atomic<bool> running_;
-  std::atomic<OrderId> nextOrderId_;
+  OrderIdAllocator orderIds_;
   size_t sleepUs_;
-};
\ No newline at end of file
+
+  // Every print, published once for all WakeOnTrade readers
+  TradeTape tape_;
+
+  // Bumped by the dispatcher; workers compare against what they last saw
+  std::atomic<uint64_t> quoteSeq_{0};
+  std::atomic<uint64_t> tradeSeq_{0};
+};
@@ -1,14 +1,84 @@
 #pragma once
+#include <algorithm>
 
 #include "Config.hpp"
 #include "Trader.hpp"
 
+// Runtime knobs for WhaleTrader; defaults come from Config. A sweepEvery
+// below 1 is clamped to 1 (sweep on every tick).
+struct WhaleTraderParams {
+  int sweepEvery = Config::wSweepEvery;
+  int sweepLevels = Config::wSweepLevels;
+  Quantity sweepQty = Config::wSweepQty;
+  Quantity icebergQty = Config::wIcebergQty;
+  int icebergRefills = Config::wIcebergRefills;
+};
+
+// Stress agent for multi-level matching. Every `sweepEvery` ticks it sends a
+// FillAndKill of `sweepQty` priced `sweepLevels` levels through the opposite
+// touch, which walks and erases every level in between. It then works the
+// same side as an iceberg: one `icebergQty` slice rests at the touch, and
+// each time a slice is filled the next one is posted, up to
+// `icebergRefills` slices. Sides alternate between sweeps so the price
+// oscillates instead of running away.
 class WhaleTrader : public Trader {
  public:
-  WhaleTrader(uint32_t id, uint64_t cash, Orderbook& ob)
-      : Trader(id, cash, Strategy::Whale, ob) {}
+  WhaleTrader(uint32_t id, uint64_t cash, Orderbook& ob,
+              WhaleTraderParams params = {})
+      : Trader(id, cash, Strategy::Whale, ob),
+        params_(clamped(params)),
+        // stagger whales by id so their sweeps do not line up
+        ticks_(int(id % uint32_t(params_.sweepEvery))) {}
 
   void tick() override {
+    const bool due = ticks_ == 0;
+    if (++ticks_ == params_.sweepEvery) ticks_ = 0;
+    if (due) {
+      sweep();
+      return;
+    }
 
+    // the previous slice left the table once it was filled (or cancelled)
+    if (refillsLeft_ > 0 && (slice_ == 0 || !orders_.find(slice_))) {
+      Price touch = side_ == Side::Buy ? ob_.topBidPrice() : ob_.topAskPrice();
+      if (touch == 0) return;
+      slice_ = placeOrder(OrderType::GoodTillCancel, touch, params_.icebergQty, side_);
+      --refillsLeft_;
+    }
   }
-};
\ No newline at end of file
+
+  uint64_t sweeps() const { return sweeps_; }
+
+ private:
+  static WhaleTraderParams clamped(WhaleTraderParams params) {
+    params.sweepEvery = std::max(params.sweepEvery, 1);
+    return params;
+  }
+
+  void sweep() {
+    side_ = side_ == Side::Buy ? Side::Sell : Side::Buy;
+    if (slice_ != 0) cancelOrder(slice_);  // drop the other side's iceberg
+    slice_ = 0;
+    refillsLeft_ = params_.icebergRefills;
+
+    Price touch, limit;
+    if (side_ == Side::Buy) {
+      touch = ob_.topAskPrice();
+      limit = touch + params_.sweepLevels;
+    } else {
+      touch = ob_.topBidPrice();
+      limit = touch > Price(params_.sweepLevels) ? touch - params_.sweepLevels : 1;
+    }
+    if (touch == 0) return;
+
+    placeOrder(OrderType::FillAndKill, limit, params_.sweepQty, side_);
+    ++sweeps_;
+  }
+
+  WhaleTraderParams params_;
+  int ticks_;
+  Side side_ = Side::Sell;  // first sweep buys
+  OrderId slice_ = 0;
+  int refillsLeft_ = 0;
+  uint64_t sweeps_ = 0;
+};
@@ -0,0 +1,71 @@
+#pragma once
+#include <cstdint>
+#include <string_view>
+#include <vector>
+
+#include "Constants.hpp"
+#include "Orderbook/Order.hpp"
+
+/* -------------------------------------------------------------------------- */
+/*                           Synthetic order flow                             */
+/* -------------------------------------------------------------------------- */
+
+enum struct Arrival { Poisson, Hawkes };
+
+// Shape of a synthetic request stream. Prices are in ticks around a mid
+// that random-walks; passive orders rest a geometric number of levels
+// behind it, marketable ones cross it. Cancels and modifies always target
+// the live order whose drawn lifetime runs out first, so short-lived
+// orders churn near the touch while long-lived ones build depth.
+struct FlowProfile {
+  const char* name;
+
+  // request mix (fractions of all events; the rest are adds)
+  double cancelP = 0.45;
+  double modifyP = 0.1;
+  size_t maxLive = 10000;  // resting-order cap: further adds become cancels
+  double amendDownP = 0;   // share of modifies that only cut size at the same price
+
+  // prices
+  Price mid = 10000;
+  double midDriftP = 0.01;  // chance per event that the mid moves one tick
+  double depthMean = 5;     // mean distance of passive orders behind the mid
+  int maxDepth = 100;       // passive orders never rest further out
+  double marketableP = 0.1; // adds priced through the mid
+  int crossLevels = 5;      // how far a marketable order may cross
+  // order type of marketable adds; immediate types never rest, so the
+  // generator does not cancel or modify them later
+  OrderType marketableType = OrderType::GoodTillCancel;
+
+  // sizes and lifetimes
+  Quantity qtyMin = 1;
+  Quantity qtyMax = 100;
+  double lifetimeMean = 1000;  // in events, exponential
+
+  // arrivals
+  Arrival arrival = Arrival::Poisson;
+  double rate = 1e6;           // mean events per second
+  double hawkesAlpha = 0;      // jump per event (branching ratio alpha/beta < 1)
+  double hawkesBeta = 0;       // decay per second
+
+  uint32_t owners = 64;
+};
+
+// One pre-generated request and the offset, from the start of the stream,
+// at which it is meant to arrive
+struct FlowEvent {
+  int64_t atNs;
+  OrderRequest request;
+};
+
+// Generates `events` requests into one flat array so that replaying them
+// costs a load per request. Order ids are dense from `firstId`; give each
+// producer its own range. Identical arguments give identical flows.
+std::vector<FlowEvent> generateFlow(const FlowProfile& profile, size_t events,
+                                    uint64_t seed = 1, OrderId firstId = 1);
+
+// Named workload profiles, see OrderFlow.cpp
+const std::vector<FlowProfile>& flowProfiles();
+
+// nullptr if there is no profile called `name`
+const FlowProfile* findFlowProfile(std::string_view name);
@@ -1,8 +1,15 @@
 #pragma once
 #include <cstddef>
+#include <chrono>
 #include <cmath>
+#include <cstdint>
 #include <string>
 
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+#include <x86intrin.h>
+
 inline size_t nextPowerOf2(size_t n)
 {
     if (n == 0) return 1;
@@ -14,4 +21,74 @@ inline std::string repeatStr(const char* s, int n) {
   std::string result;
   for (int i = 0; i < n; i++) result += s;
   return result;
-}
\ No newline at end of file
+}
+
+// Monotonic clock in nanoseconds, for deadlines and timeouts.
+inline int64_t nowNs() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+             std::chrono::steady_clock::now().time_since_epoch())
+      .count();
+}
+
+// Raw time-stamp counter. Invariant TSCs tick at a constant rate and are
+// synchronised across cores, so stamps taken on different threads compare.
+inline uint64_t rdtsc() { return __rdtsc(); }
+
+// TSC ticks per nanosecond, calibrated once against steady_clock (~10 ms)
+inline double tscPerNs() {
+  static const double ratio = [] {
+    int64_t t0 = nowNs();
+    uint64_t c0 = rdtsc();
+    while (nowNs() - t0 < 10000000) {}
+    int64_t t1 = nowNs();
+    uint64_t c1 = rdtsc();
+    return double(c1 - c0) / double(t1 - t0);
+  }();
+  return ratio;
+}
+
+// Pins a thread to one core; returns the pthread error code (0 on success).
+inline int pinThread(pthread_t thread, int coreId) {
+  cpu_set_t cpuset;
+  CPU_ZERO(&cpuset);
+  CPU_SET(coreId, &cpuset);
+  return pthread_setaffinity_np(thread, sizeof(cpu_set_t), &cpuset);
+}
+
+// Lets the calling thread run on any CPU the process may use again. Threads
+// inherit their creator's mask, so helpers spawned by a pinned thread call
+// this to avoid competing with it for its core.
+inline void unpinThread() {
+  cpu_set_t all;
+  if (sched_getaffinity(getpid(), sizeof(all), &all) == 0)
+    sched_setaffinity(0, sizeof(all), &all);
+}
+
+// NUMA node of the CPU the calling thread is running on (pin it first)
+inline int currentNumaNode() {
+  unsigned cpu = 0, node = 0;
+  if (getcpu(&cpu, &node) != 0) return -1;
+  return (int)node;
+}
+
+// Small, seedable UniformRandomBitGenerator (SplitMix64). Eight bytes of
+// state, so every simulated agent can own a deterministic stream.
+class SplitMix64 {
+ public:
+  using result_type = uint64_t;
+
+  explicit SplitMix64(uint64_t seed) : state_(seed) {}
+
+  static constexpr result_type min() { return 0; }
+  static constexpr result_type max() { return ~result_type{0}; }
+
+  result_type operator()() {
+    uint64_t z = (state_ += 0x9e3779b97f4a7c15ULL);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+  }
+
+ private:
+  uint64_t state_;
+};
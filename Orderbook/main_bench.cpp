@@ -0,0 +1,142 @@
+// main_bench.cpp  –  Engine benchmark scenarios with machine-readable output
+//
+//   order_book_bench --scenarios insert-only,deep-sweep --events 1000000
+//                    --warmup 1 --reps 5 --producers 1,2,4
+//                    --format json --out bench.json
+//   order_book_bench --format csv --out current.csv --baseline baseline.csv
+//                    --tolerance 0.1
+//   order_book_bench --scenarios open-loop --loads 0.1,0.5,0.9,1.2
+//                    [--capacity 2500000]
+//   order_book_bench --scenarios deep-sweep --perf
+//
+// Every scenario reports median throughput and p50/p99/p99.9 per-request
+// latency. With --baseline (a CSV written by an earlier run) each result
+// is compared against the stored one, and the exit status is 2 if anything
+// regressed beyond the tolerance. --perf adds hardware counters per request
+// (cycles, instructions, L1D/LLC/dTLB and branch misses) taken on the
+// matching thread; counters the machine does not expose are left out.
+#include "Bench/Bench.hpp"
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+static std::vector<std::string> parseNames(const char* arg) {
+  std::vector<std::string> names;
+  std::stringstream ss(arg);
+  std::string item;
+  while (std::getline(ss, item, ','))
+    if (!item.empty()) names.push_back(item);
+  return names;
+}
+
+int main(int argc, char** argv) {
+  BenchOptions options;
+  std::vector<std::string> names;
+  std::string format = "json";
+  const char* outPath = nullptr;
+  const char* baselinePath = nullptr;
+  double tolerance = 0.1;
+
+  for (int i = 1; i < argc; ++i) {
+    const char* key = argv[i];
+    if (!std::strcmp(key, "--list")) {
+      for (const BenchScenario& s : benchScenarios())
+        std::printf("%-20s %s\n", s.name, s.description);
+      return 0;
+    }
+    if (!std::strcmp(key, "--perf")) {
+      options.perf = true;
+      continue;
+    }
+    if (i + 1 >= argc) {
+      std::fprintf(stderr, "Missing value for %s\n", key);
+      return 1;
+    }
+    const char* val = argv[++i];
+    if (!std::strcmp(key, "--scenarios")) names = parseNames(val);
+    else if (!std::strcmp(key, "--events")) options.events = std::strtoull(val, nullptr, 10);
+    else if (!std::strcmp(key, "--warmup")) options.warmup = std::atoi(val);
+    else if (!std::strcmp(key, "--reps")) options.reps = std::atoi(val);
+    else if (!std::strcmp(key, "--producers")) {
+      options.producers.clear();
+      for (auto& n : parseNames(val)) options.producers.push_back(std::atoi(n.c_str()));
+    }
+    else if (!std::strcmp(key, "--loads")) {
+      options.loads.clear();
+      for (auto& l : parseNames(val)) options.loads.push_back(std::atof(l.c_str()));
+    }
+    else if (!std::strcmp(key, "--capacity")) options.capacity = std::atof(val);
+    else if (!std::strcmp(key, "--format")) format = val;
+    else if (!std::strcmp(key, "--out")) outPath = val;
+    else if (!std::strcmp(key, "--baseline")) baselinePath = val;
+    else if (!std::strcmp(key, "--tolerance")) tolerance = std::atof(val);
+    else {
+      std::fprintf(stderr, "Unknown option: %s\n", key);
+      return 1;
+    }
+  }
+
+  if (format != "json" && format != "csv") {
+    std::fprintf(stderr, "Unknown format: %s (json or csv)\n", format.c_str());
+    return 1;
+  }
+  if (options.reps < 1 || options.events == 0) {
+    std::fprintf(stderr, "--reps and --events must be positive\n");
+    return 1;
+  }
+
+  std::vector<const BenchScenario*> selected;
+  if (names.empty()) {
+    for (const BenchScenario& s : benchScenarios()) selected.push_back(&s);
+  } else {
+    for (const std::string& n : names) {
+      const BenchScenario* s = findBenchScenario(n);
+      if (!s) {
+        std::fprintf(stderr, "Unknown scenario: %s (see --list)\n", n.c_str());
+        return 1;
+      }
+      selected.push_back(s);
+    }
+  }
+
+  std::vector<BenchResult> results;
+  for (const BenchScenario* s : selected) {
+    std::fprintf(stderr, "Running %s...\n", s->name);
+    for (BenchResult& r : s->run(*s, options)) results.push_back(r);
+  }
+
+  if (outPath) {
+    std::ofstream out(outPath);
+    if (format == "csv") writeCsv(out, results);
+    else writeJson(out, results);
+  } else {
+    if (format == "csv") writeCsv(std::cout, results);
+    else writeJson(std::cout, results);
+  }
+
+  if (!baselinePath) return 0;
+
+  std::ifstream in(baselinePath);
+  if (!in) {
+    std::fprintf(stderr, "Cannot read baseline %s\n", baselinePath);
+    return 1;
+  }
+  std::vector<BenchRegression> regressions =
+      compareToBaseline(readCsv(in), results, tolerance);
+  for (const BenchRegression& r : regressions) {
+    std::fprintf(stderr, "REGRESSION %s (producers=%d, load=%.2f) %s: %.1f -> %.1f (%+.1f%%)\n",
+                 r.scenario.c_str(), r.producers, r.load, r.metric.c_str(), r.baseline,
+                 r.current, (r.current / r.baseline - 1) * 100);
+  }
+  if (regressions.empty())
+    std::fprintf(stderr, "No regressions against %s (tolerance %.0f%%)\n", baselinePath,
+                 tolerance * 100);
+
+  return regressions.empty() ? 0 : 2;
+}
@@ -0,0 +1,688 @@
+#include "Bench/Bench.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <map>
+#include <memory>
+#include <random>
+#include <sstream>
+#include <thread>
+
+#include "Orderbook/NodeArena.hpp"
+#include "Orderbook/Orderbook.hpp"
+#include "Orderbook/PriceLadder.hpp"
+#include "Workload/OrderFlow.hpp"
+#include "utils.hpp"
+
+namespace {
+
+double percentile(std::vector<int64_t>& samples, double q) {
+  if (samples.empty()) return 0;
+  size_t i = std::min(samples.size() - 1, size_t(q * double(samples.size())));
+  std::nth_element(samples.begin(), samples.begin() + i, samples.end());
+  return double(samples[i]);
+}
+
+double median(std::vector<double> values) {
+  if (values.empty()) return 0;
+  std::sort(values.begin(), values.end());
+  return values[values.size() / 2];
+}
+
+BenchResult summarize(const BenchScenario& scenario, int producers, size_t ops,
+                      int reps, std::vector<int64_t>& latencies,
+                      std::vector<double>& throughputs, double load = 0) {
+  BenchResult r;
+  r.scenario = scenario.name;
+  r.producers = producers;
+  r.load = load;
+  r.ops = ops;
+  r.reps = reps;
+  r.opsPerSec = median(throughputs);
+  r.p50Ns = percentile(latencies, 0.5);
+  r.p99Ns = percentile(latencies, 0.99);
+  r.p999Ns = percentile(latencies, 0.999);
+  return r;
+}
+
+// Sums counter totals over the measured repetitions of one result
+struct PerfTally {
+  double counts[PerfCounters::kEvents] = {};
+  bool captured[PerfCounters::kEvents] = {};
+
+  void add(const PerfCounters& c) {
+    if (!c.available()) {
+      static bool warned = false;
+      if (!warned)
+        std::fprintf(stderr, "  hardware counters unavailable (%s): no PMU exposed, or "
+                     "kernel.perf_event_paranoid > 2\n", c.error());
+      warned = true;
+      return;
+    }
+    for (size_t e = 0; e < PerfCounters::kEvents; ++e) {
+      if (!c.has(PerfEvent(e))) continue;
+      captured[e] = true;
+      counts[e] += c.total(PerfEvent(e));
+    }
+  }
+
+  void fill(BenchResult& r) const {
+    const double ops = double(r.ops) * double(r.reps);
+    for (size_t e = 0; e < PerfCounters::kEvents; ++e)
+      if (captured[e]) r.perfPerOp[e] = counts[e] / ops;
+
+    const double cycles = r.perfPerOp[size_t(PerfEvent::Cycles)];
+    const double instructions = r.perfPerOp[size_t(PerfEvent::Instructions)];
+    if (cycles > 0 && instructions >= 0)
+      std::fprintf(stderr, "  %-14s producers=%d cycles/op=%.0f instr/op=%.0f IPC=%.2f\n",
+                   r.scenario.c_str(), r.producers, cycles, instructions, instructions / cycles);
+  }
+};
+
+#ifdef OB_ENABLE_LATENCY
+// Per-type breakdown of the last repetition; waits until the matching
+// thread has recorded all `ops` order requests
+void reportLatency(const char* scenario, const Orderbook& ob, size_t ops) {
+  const LatencyStats& stats = ob.latencyStats();
+  auto recorded = [&stats]() {
+    return stats[RequestType::Add].total.count() + stats[RequestType::Cancel].total.count() +
+           stats[RequestType::Modify].total.count();
+  };
+  while (recorded() < ops) std::this_thread::yield();
+
+  const double perNs = tscPerNs();
+  const char* names[] = {"add", "cancel", "modify", "stop", "snapshot", "cancel-all", "quote"};
+  for (size_t t = 0; t < LatencyStats::kTypes; ++t) {
+    const RequestLatency& l = stats.byType[t];
+    if (l.total.count() == 0) continue;
+    auto row = [&](const char* stage, const LatencyHistogram& h) {
+      std::fprintf(stderr, "  %-14s %-8s %-8s n=%-9llu p50=%.0fns p99=%.0fns p99.9=%.0fns max=%.0fns\n",
+                   scenario, names[t], stage, (unsigned long long)h.count(),
+                   h.percentile(0.5) / perNs, h.percentile(0.99) / perNs,
+                   h.percentile(0.999) / perNs, h.max() / perNs);
+    };
+    row("queue", l.queue);
+    row("service", l.service);
+    row("total", l.total);
+  }
+}
+#endif
+
+/* ----------------------------- Inline replay ------------------------------ */
+
+// Runs `flow` through a fresh inline book; one latency sample per request.
+// With a tally, counts this thread (which does the matching) over the replay.
+double replayInline(const char* scenario, const std::vector<FlowEvent>& flow,
+                    int64_t* latencies, bool report, PerfTally* tally = nullptr) {
+  Orderbook ob(nextPowerOf2(flow.size() + 1), -1, EngineMode::Inline);
+  std::unique_ptr<PerfCounters> counters;
+  if (tally) counters = std::make_unique<PerfCounters>();
+
+  if (counters) counters->start();
+  int64_t start = nowNs();
+  for (size_t i = 0; i < flow.size(); ++i) {
+    OrderRequest req = flow[i].request;
+    int64_t t0 = nowNs();
+    ob.submitRequest(req);
+    if (latencies) latencies[i] = nowNs() - t0;
+  }
+  double opsPerSec = double(flow.size()) * 1e9 / double(nowNs() - start);
+  if (counters) {
+    counters->stop();
+    tally->add(*counters);
+  }
+
+#ifdef OB_ENABLE_LATENCY
+  if (report) reportLatency(scenario, ob, flow.size());
+#else
+  (void)scenario;
+  (void)report;
+#endif
+  return opsPerSec;
+}
+
+std::vector<BenchResult> runInline(const BenchScenario& scenario,
+                                   const BenchOptions& options,
+                                   const FlowProfile& profile) {
+  std::vector<FlowEvent> flow = generateFlow(profile, options.events);
+
+  for (int w = 0; w < options.warmup; ++w) replayInline(scenario.name, flow, nullptr, false);
+
+  PerfTally tally;
+  std::vector<int64_t> latencies(flow.size() * size_t(options.reps));
+  std::vector<double> throughputs;
+  for (int r = 0; r < options.reps; ++r) {
+    throughputs.push_back(replayInline(scenario.name, flow,
+                                       latencies.data() + size_t(r) * flow.size(),
+                                       r + 1 == options.reps, options.perf ? &tally : nullptr));
+  }
+
+  BenchResult result = summarize(scenario, 1, flow.size(), options.reps, latencies, throughputs);
+  if (options.perf) tally.fill(result);
+  return {result};
+}
+
+FlowProfile variant(const char* base, const char* name) {
+  FlowProfile p = *findFlowProfile(base);
+  p.name = name;
+  return p;
+}
+
+std::vector<BenchResult> insertOnly(const BenchScenario& s, const BenchOptions& o) {
+  FlowProfile p = variant("balanced", s.name);
+  p.cancelP = 0;
+  p.modifyP = 0;
+  p.marketableP = 0;
+  p.maxLive = SIZE_MAX;
+  return runInline(s, o, p);
+}
+
+std::vector<BenchResult> cancelHeavy(const BenchScenario& s, const BenchOptions& o) {
+  return runInline(s, o, variant("hft-churn", s.name));
+}
+
+std::vector<BenchResult> deepSweep(const BenchScenario& s, const BenchOptions& o) {
+  return runInline(s, o, variant("sweep-heavy", s.name));
+}
+
+std::vector<BenchResult> modifyHeavy(const BenchScenario& s, const BenchOptions& o) {
+  FlowProfile p = variant("balanced", s.name);
+  p.cancelP = 0.1;
+  p.modifyP = 0.45;
+  return runInline(s, o, p);
+}
+
+std::vector<BenchResult> amendDown(const BenchScenario& s, const BenchOptions& o) {
+  FlowProfile p = variant("balanced", s.name);
+  p.cancelP = 0.1;
+  p.modifyP = 0.45;
+  p.amendDownP = 0.8;
+  return runInline(s, o, p);
+}
+
+std::vector<BenchResult> fokHeavy(const BenchScenario& s, const BenchOptions& o) {
+  FlowProfile p = variant("balanced", s.name);
+  p.marketableP = 0.3;
+  p.crossLevels = 20;
+  p.marketableType = OrderType::FillOrKill;
+  return runInline(s, o, p);
+}
+
+/* ------------------------------ Market makers ----------------------------- */
+
+// kMakers owners re-quote both sides around a drifting mid, each re-quote
+// sent either as one Quote request or as the four it replaces (cancel
+// bid, cancel ask, add bid, add ask). Half the re-quotes keep their prices
+// and only trim size; every kTakeEvery-th is followed by a FillAndKill
+// through the spread. One latency sample and one op per re-quote.
+constexpr uint32_t kMakers = 64;
+constexpr size_t kTakeEvery = 16;
+
+std::vector<std::vector<OrderRequest>> requoteFlow(size_t requotes, bool asQuote) {
+  struct Maker {
+    OrderId bidId = 0, askId = 0;
+    Price bid = 0, ask = 0;
+    Quantity bidQty = 0, askQty = 0;
+  };
+  std::vector<Maker> makers(kMakers);
+  SplitMix64 gen(11);
+  Price mid = 100000;
+  OrderId nextId = 1;
+
+  std::vector<std::vector<OrderRequest>> groups(requotes);
+  for (size_t i = 0; i < requotes; ++i) {
+    const uint32_t owner = 1 + uint32_t(gen() % kMakers);
+    Maker& m = makers[owner - 1];
+    mid += Price(gen() % 3) - 1;
+    if (m.bidQty == 0 || gen() % 2) {
+      m.bid = mid - 1 - gen() % 3;
+      m.ask = mid + 1 + gen() % 3;
+      m.bidQty = 50 + gen() % 50;
+      m.askQty = 50 + gen() % 50;
+    } else {
+      m.bidQty -= std::min<Quantity>(m.bidQty - 1, gen() % 10);
+      m.askQty -= std::min<Quantity>(m.askQty - 1, gen() % 10);
+    }
+
+    std::vector<OrderRequest>& g = groups[i];
+    if (!asQuote && m.bidId != 0) {
+      g.push_back({RequestType::Cancel, Order(m.bidId, owner, OrderType::GoodTillCancel, 0, 0, Side::Buy)});
+      g.push_back({RequestType::Cancel, Order(m.askId, owner, OrderType::GoodTillCancel, 0, 0, Side::Sell)});
+    }
+    m.bidId = nextId++;
+    m.askId = nextId++;
+    Order bid(m.bidId, owner, OrderType::GoodTillCancel, m.bid, m.bidQty, Side::Buy);
+    if (asQuote) {
+      g.push_back({RequestType::Quote, bid});
+      g.back().ask = {m.askId, m.ask, m.askQty};
+    } else {
+      g.push_back({RequestType::Add, bid});
+      g.push_back({RequestType::Add, Order(m.askId, owner, OrderType::GoodTillCancel, m.ask, m.askQty, Side::Sell)});
+    }
+
+    if (i % kTakeEvery == kTakeEvery - 1) {
+      const Side side = gen() % 2 ? Side::Buy : Side::Sell;
+      g.push_back({RequestType::Add, Order(nextId++, 0, OrderType::FillAndKill,
+                                           side == Side::Buy ? mid + 10 : mid - 10, 100, side)});
+    }
+  }
+  return groups;
+}
+
+std::vector<BenchResult> requote(const BenchScenario& s, const BenchOptions& o, bool asQuote) {
+  const std::vector<std::vector<OrderRequest>> groups = requoteFlow(o.events, asQuote);
+  std::vector<int64_t> latencies;
+  std::vector<double> throughputs;
+
+  for (int r = -o.warmup; r < o.reps; ++r) {
+    Orderbook ob(4 * kMakers, -1, EngineMode::Inline);
+    int64_t start = nowNs();
+    for (const auto& g : groups) {
+      int64_t t0 = nowNs();
+      for (OrderRequest req : g) ob.submitRequest(req);
+      if (r >= 0) latencies.push_back(nowNs() - t0);
+    }
+    if (r >= 0) throughputs.push_back(double(groups.size()) * 1e9 / double(nowNs() - start));
+  }
+  return {summarize(s, 1, groups.size(), o.reps, latencies, throughputs)};
+}
+
+std::vector<BenchResult> quotePairs(const BenchScenario& s, const BenchOptions& o) {
+  return requote(s, o, true);
+}
+
+std::vector<BenchResult> requoteCancelAdd(const BenchScenario& s, const BenchOptions& o) {
+  return requote(s, o, false);
+}
+
+/* ------------------------- Price level containers ------------------------- */
+
+// The ask side's level container on its own: kWalkLevels levels are added
+// untimed, then swept best first, each step dropping the best level and
+// finding the next one (what matchOrders does whenever a level empties).
+// Dense books occupy consecutive ticks; sparse ones leave random gaps of
+// up to 2 * kSparseGap ticks. A step is below the clock's resolution, so
+// each sweep gives one latency sample, divided over its levels.
+constexpr size_t kWalkLevels = 1024;
+constexpr Price kSparseGap = 64;
+
+struct LadderSide {
+  PriceLadder<Side::Sell> ladder;
+
+  void add(Price p) { ladder.level(p); }
+  bool empty() const { return ladder.empty(); }
+  Price popBest() {
+    Price p = ladder.best();
+    ladder.remove(p);
+    return p;
+  }
+};
+
+// The book's previous layout: a std::map whose nodes are recycled
+struct MapSide {
+  using Allocator = NodeAllocator<std::pair<const Price, PriceLevel>>;
+  NodeArena arena{kWalkLevels};
+  std::map<Price, PriceLevel, std::less<Price>, Allocator> levels{Allocator(&arena)};
+
+  void add(Price p) { levels.try_emplace(p); }
+  bool empty() const { return levels.empty(); }
+  Price popBest() {
+    Price p = levels.begin()->first;
+    levels.erase(levels.begin());
+    return p;
+  }
+};
+
+template <typename LevelSide>
+std::vector<BenchResult> levelWalk(const BenchScenario& s, const BenchOptions& o, bool sparse) {
+  // shuffled, as a book is built up over time rather than in price order
+  SplitMix64 gen(7);
+  std::vector<Price> prices;
+  Price p = 10000;
+  for (size_t i = 0; i < kWalkLevels; ++i) {
+    prices.push_back(p);
+    p += sparse ? 1 + gen() % (2 * kSparseGap) : 1;
+  }
+  std::shuffle(prices.begin(), prices.end(), gen);
+
+  const size_t sweeps = std::max<size_t>(1, o.events / kWalkLevels);
+  auto side = std::make_unique<LevelSide>();
+  std::vector<int64_t> latencies;
+  std::vector<double> throughputs;
+  Price sink = 0;
+
+  for (int r = -o.warmup; r < o.reps; ++r) {
+    int64_t busy = 0;
+    for (size_t i = 0; i < sweeps; ++i) {
+      for (Price price : prices) side->add(price);
+      int64_t t0 = nowNs();
+      while (!side->empty()) sink += side->popBest();
+      int64_t ns = nowNs() - t0;
+      busy += ns;
+      if (r >= 0) latencies.push_back(ns / int64_t(kWalkLevels));
+    }
+    if (r >= 0) throughputs.push_back(double(sweeps * kWalkLevels) * 1e9 / double(busy));
+  }
+  if (sink == 0) std::fprintf(stderr, "  empty sweep\n");  // keeps the walk observable
+
+  return {summarize(s, 1, sweeps * kWalkLevels, o.reps, latencies, throughputs)};
+}
+
+std::vector<BenchResult> ladderDense(const BenchScenario& s, const BenchOptions& o) {
+  return levelWalk<LadderSide>(s, o, false);
+}
+
+std::vector<BenchResult> ladderSparse(const BenchScenario& s, const BenchOptions& o) {
+  return levelWalk<LadderSide>(s, o, true);
+}
+
+std::vector<BenchResult> mapDense(const BenchScenario& s, const BenchOptions& o) {
+  return levelWalk<MapSide>(s, o, false);
+}
+
+std::vector<BenchResult> mapSparse(const BenchScenario& s, const BenchOptions& o) {
+  return levelWalk<MapSide>(s, o, true);
+}
+
+/* ---------------------------- Threaded replay ----------------------------- */
+
+// Every producer submits its own flow to one threaded book; `observer`
+// (may be empty) runs on its own thread for the duration. With a tally,
+// counts the matching thread from the start signal until the ring drains.
+template <typename Observer>
+double replayThreaded(const char* scenario, const std::vector<std::vector<FlowEvent>>& flows,
+                      std::vector<std::vector<int64_t>>* latencies, bool report,
+                      Observer&& observer, PerfTally* tally = nullptr) {
+  size_t total = 0;
+  for (auto& f : flows) total += f.size();
+
+  auto ob = std::make_unique<Orderbook>(nextPowerOf2(total + 1));
+  std::unique_ptr<PerfCounters> counters;
+  if (tally) counters = std::make_unique<PerfCounters>(ob->matchingThreadId());
+  std::atomic<bool> done{false};
+  std::atomic<size_t> ready{0};
+  std::atomic<bool> go{false};
+
+  std::vector<std::thread> producers;
+  for (size_t p = 0; p < flows.size(); ++p) {
+    producers.emplace_back([&, p]() {
+      const auto& flow = flows[p];
+      int64_t* lat = latencies ? (*latencies)[p].data() : nullptr;
+      ready.fetch_add(1);
+      while (!go.load(std::memory_order_acquire)) std::this_thread::yield();
+
+      for (size_t i = 0; i < flow.size(); ++i) {
+        OrderRequest req = flow[i].request;
+        int64_t t0 = nowNs();
+        ob->submitRequest(req);
+        if (lat) lat[i] = nowNs() - t0;
+      }
+    });
+  }
+  std::thread watcher([&]() { observer(*ob, done); });
+
+  while (ready.load() != flows.size()) std::this_thread::yield();
+  if (counters) counters->start();
+  int64_t start = nowNs();
+  go.store(true, std::memory_order_release);
+
+  for (auto& t : producers) t.join();
+  done.store(true);
+  watcher.join();
+
+  if (counters) {
+    while (ob->processedRequests() < total) std::this_thread::yield();
+    counters->stop();
+    tally->add(*counters);
+  }
+
+#ifdef OB_ENABLE_LATENCY
+  if (report) reportLatency(scenario, *ob, total);
+#else
+  (void)scenario;
+  (void)report;
+#endif
+
+  ob.reset();  // drains the ring
+  return double(total) * 1e9 / double(nowNs() - start);
+}
+
+template <typename Observer>
+BenchResult runThreaded(const BenchScenario& scenario, const BenchOptions& options,
+                        int producers, Observer&& observer) {
+  const FlowProfile& profile = *findFlowProfile("balanced");
+  const size_t perProducer = options.events / size_t(producers);
+
+  std::vector<std::vector<FlowEvent>> flows;
+  for (int p = 0; p < producers; ++p)
+    flows.push_back(generateFlow(profile, perProducer, 1 + p, OrderId(p) * perProducer + 1));
+
+  for (int w = 0; w < options.warmup; ++w)
+    replayThreaded(scenario.name, flows, nullptr, false, observer);
+
+  PerfTally tally;
+  std::vector<int64_t> pooled;
+  std::vector<double> throughputs;
+  for (int r = 0; r < options.reps; ++r) {
+    std::vector<std::vector<int64_t>> latencies(producers, std::vector<int64_t>(perProducer));
+    throughputs.push_back(replayThreaded(scenario.name, flows, &latencies, r + 1 == options.reps,
+                                         observer, options.perf ? &tally : nullptr));
+    for (auto& l : latencies) pooled.insert(pooled.end(), l.begin(), l.end());
+  }
+
+  BenchResult result = summarize(scenario, producers, perProducer * size_t(producers),
+                                 options.reps, pooled, throughputs);
+  if (options.perf) tally.fill(result);
+  return result;
+}
+
+std::vector<BenchResult> multiProducer(const BenchScenario& s, const BenchOptions& o) {
+  std::vector<BenchResult> results;
+  for (int n : o.producers)
+    if (n > 0) results.push_back(runThreaded(s, o, n, [](Orderbook&, std::atomic<bool>&) {}));
+  return results;
+}
+
+/* ------------------------------- Open loop -------------------------------- */
+
+// Sends flow[i] at start + i / rate whether or not the book kept up, and
+// timestamps completion by watching processedRequests() from this thread.
+// Returns the achieved throughput; latencies[i] is completion - intended.
+double replayOpenLoop(const std::vector<FlowEvent>& flow, double rate, int64_t* latencies) {
+  const size_t n = flow.size();
+  const double gapNs = 1e9 / rate;
+  auto ob = std::make_unique<Orderbook>(nextPowerOf2(n + 1));
+
+  const int64_t start = nowNs() + 1000000;  // leave the producer time to spin up
+  std::thread producer([&]() {
+    for (size_t i = 0; i < n; ++i) {
+      const int64_t intended = start + int64_t(double(i) * gapNs);
+      while (nowNs() < intended) {}
+      OrderRequest req = flow[i].request;
+      ob->submitRequest(req);
+    }
+  });
+
+  size_t done = 0;
+  while (done < n) {
+    const uint64_t processed = std::min<uint64_t>(ob->processedRequests(), n);
+    if (processed == done) continue;
+    const int64_t now = nowNs();
+    for (; done < processed; ++done)
+      latencies[done] = now - (start + int64_t(double(done) * gapNs));
+  }
+  const int64_t end = nowNs();
+
+  producer.join();
+  ob.reset();
+  return double(n) * 1e9 / double(end - start);
+}
+
+std::vector<BenchResult> openLoop(const BenchScenario& s, const BenchOptions& o) {
+  const FlowProfile& profile = *findFlowProfile("balanced");
+  std::vector<FlowEvent> flow = generateFlow(profile, o.events);
+
+  double capacity = o.capacity;
+  if (capacity <= 0) {
+    std::vector<double> runs;
+    std::vector<std::vector<FlowEvent>> flows{flow};
+    auto noop = [](Orderbook&, std::atomic<bool>&) {};
+    for (int r = 0; r < std::max(1, o.reps); ++r)
+      runs.push_back(replayThreaded(s.name, flows, nullptr, false, noop));
+    capacity = median(runs);
+  }
+  std::fprintf(stderr, "  capacity %.0f requests/sec\n", capacity);
+
+  std::vector<BenchResult> results;
+  for (double load : o.loads) {
+    if (load <= 0) continue;
+    const double rate = capacity * load;
+
+    std::vector<int64_t> scratch(flow.size());
+    for (int w = 0; w < o.warmup; ++w) replayOpenLoop(flow, rate, scratch.data());
+
+    std::vector<int64_t> latencies(flow.size() * size_t(o.reps));
+    std::vector<double> throughputs;
+    for (int r = 0; r < o.reps; ++r)
+      throughputs.push_back(replayOpenLoop(flow, rate, latencies.data() + size_t(r) * flow.size()));
+
+    results.push_back(summarize(s, 1, flow.size(), o.reps, latencies, throughputs, load));
+    const BenchResult& b = results.back();
+    std::fprintf(stderr, "  load %3.0f%%: %.0f/s achieved, p50 %.0f ns, p99 %.0f ns\n",
+                 load * 100, b.opsPerSec, b.p50Ns, b.p99Ns);
+  }
+  return results;
+}
+
+#ifdef OB_ENABLE_UI
+// A UI-style observer requests and reads a snapshot every millisecond while
+// one producer streams the balanced flow
+std::vector<BenchResult> snapshotUnderLoad(const BenchScenario& s, const BenchOptions& o) {
+  return {runThreaded(s, o, 1, [](Orderbook& ob, std::atomic<bool>& done) {
+    while (!done.load(std::memory_order_acquire)) {
+      OrderRequest req;
+      req.type = RequestType::Snapshot;
+      ob.submitRequest(req);
+      OrderBookSnapshot snap = ob.getSnapshot();
+      (void)snap;
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+  })};
+}
+#endif
+
+}  // namespace
+
+const std::vector<BenchScenario>& benchScenarios() {
+  static const std::vector<BenchScenario> scenarios = {
+      {"insert-only", "passive GTC adds spread over many levels", insertOnly},
+      {"cancel-heavy", "hft-churn flow: cancels at the touch in Hawkes bursts", cancelHeavy},
+      {"deep-sweep", "sweep-heavy flow: marketable orders walking many levels", deepSweep},
+      {"modify-heavy", "balanced flow with 45% modifies", modifyHeavy},
+      {"amend-down", "modify-heavy, but 80% of modifies only cut size at the same price", amendDown},
+      {"fok-heavy", "balanced flow, 30% of adds FillOrKill through the mid", fokHeavy},
+      {"quote-pairs", "64 market makers re-quoting both sides, one Quote request each", quotePairs},
+      {"requote-cancel-add", "the same re-quotes as cancel bid, cancel ask, add bid, add ask", requoteCancelAdd},
+      {"ladder-dense", "price ladder: drop the best of 1024 adjacent levels, find the next", ladderDense},
+      {"ladder-sparse", "price ladder: the same over levels up to 128 ticks apart", ladderSparse},
+      {"map-dense", "std::map levels: drop the best of 1024 adjacent levels, find the next", mapDense},
+      {"map-sparse", "std::map levels: the same over levels up to 128 ticks apart", mapSparse},
+      {"multi-producer", "balanced flow from N producers into a threaded book", multiProducer},
+      {"open-loop", "fixed-rate schedule from 10% to 120% of capacity, latency vs. intended send time", openLoop},
+#ifdef OB_ENABLE_UI
+      {"snapshot-under-load", "one producer while an observer polls snapshots", snapshotUnderLoad},
+#endif
+  };
+  return scenarios;
+}
+
+const BenchScenario* findBenchScenario(const std::string& name) {
+  for (const BenchScenario& s : benchScenarios())
+    if (name == s.name) return &s;
+  return nullptr;
+}
+
+/* --------------------------------- Output --------------------------------- */
+
+void writeJson(std::ostream& out, const std::vector<BenchResult>& results) {
+  out << "{\n  \"results\": [";
+  for (size_t i = 0; i < results.size(); ++i) {
+    const BenchResult& r = results[i];
+    out << (i ? "," : "") << "\n    {\"scenario\": \"" << r.scenario << "\", \"producers\": "
+        << r.producers << ", \"load\": " << r.load << ", \"ops\": " << r.ops << ", \"reps\": " << r.reps
+        << ", \"ops_per_sec\": " << r.opsPerSec << ", \"p50_ns\": " << r.p50Ns
+        << ", \"p99_ns\": " << r.p99Ns << ", \"p999_ns\": " << r.p999Ns;
+    for (size_t e = 0; e < PerfCounters::kEvents; ++e)
+      if (r.perfPerOp[e] >= 0)
+        out << ", \"" << PerfCounters::name(PerfEvent(e)) << "_per_op\": " << r.perfPerOp[e];
+    out << "}";
+  }
+  out << "\n  ]\n}\n";
+}
+
+void writeCsv(std::ostream& out, const std::vector<BenchResult>& results) {
+  out << "scenario,producers,load,ops,reps,ops_per_sec,p50_ns,p99_ns,p999_ns";
+  for (size_t e = 0; e < PerfCounters::kEvents; ++e)
+    out << ',' << PerfCounters::name(PerfEvent(e)) << "_per_op";
+  out << '\n';
+
+  // counters that were not captured are left empty
+  for (const BenchResult& r : results) {
+    out << r.scenario << ',' << r.producers << ',' << r.load << ',' << r.ops << ',' << r.reps << ','
+        << r.opsPerSec << ',' << r.p50Ns << ',' << r.p99Ns << ',' << r.p999Ns;
+    for (double v : r.perfPerOp) {
+      out << ',';
+      if (v >= 0) out << v;
+    }
+    out << '\n';
+  }
+}
+
+std::vector<BenchResult> readCsv(std::istream& in) {
+  std::vector<BenchResult> results;
+  std::string line;
+  std::getline(in, line);  // header
+  while (std::getline(in, line)) {
+    if (line.empty()) continue;
+    std::stringstream ss(line);
+    std::string field;
+    std::vector<std::string> f;
+    while (std::getline(ss, field, ',')) f.push_back(field);
+    if (f.size() < 9) continue;
+
+    BenchResult r;
+    r.scenario = f[0];
+    r.producers = std::stoi(f[1]);
+    r.load = std::stod(f[2]);
+    r.ops = std::stoull(f[3]);
+    r.reps = std::stoi(f[4]);
+    r.opsPerSec = std::stod(f[5]);
+    r.p50Ns = std::stod(f[6]);
+    r.p99Ns = std::stod(f[7]);
+    r.p999Ns = std::stod(f[8]);
+    for (size_t e = 0; e < PerfCounters::kEvents && 9 + e < f.size(); ++e)
+      if (!f[9 + e].empty()) r.perfPerOp[e] = std::stod(f[9 + e]);
+    results.push_back(r);
+  }
+  return results;
+}
+
+std::vector<BenchRegression> compareToBaseline(const std::vector<BenchResult>& baseline,
+                                               const std::vector<BenchResult>& current,
+                                               double tolerance) {
+  std::vector<BenchRegression> regressions;
+  for (const BenchResult& c : current) {
+    for (const BenchResult& b : baseline) {
+      if (b.scenario != c.scenario || b.producers != c.producers) continue;
+      if (std::abs(b.load - c.load) > 1e-9) continue;
+      if (c.opsPerSec < b.opsPerSec * (1 - tolerance))
+        regressions.push_back({c.scenario, c.producers, c.load, "ops_per_sec", b.opsPerSec, c.opsPerSec});
+      if (c.p99Ns > b.p99Ns * (1 + tolerance))
+        regressions.push_back({c.scenario, c.producers, c.load, "p99_ns", b.p99Ns, c.p99Ns});
+    }
+  }
+  return regressions;
+}
@@ -0,0 +1,91 @@
+#include "Bench/PerfCounters.hpp"
+
+#include <cerrno>
+#include <cstring>
+
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace {
+
+struct EventSpec {
+  uint32_t type;
+  uint64_t config;
+};
+
+constexpr uint64_t cacheConfig(uint64_t cache, uint64_t op, uint64_t result) {
+  return cache | (op << 8) | (result << 16);
+}
+
+// Indexed by PerfEvent
+constexpr EventSpec kSpecs[PerfCounters::kEvents] = {
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+    {PERF_TYPE_HW_CACHE, cacheConfig(PERF_COUNT_HW_CACHE_L1D, PERF_COUNT_HW_CACHE_OP_READ,
+                                     PERF_COUNT_HW_CACHE_RESULT_MISS)},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+    {PERF_TYPE_HW_CACHE, cacheConfig(PERF_COUNT_HW_CACHE_DTLB, PERF_COUNT_HW_CACHE_OP_READ,
+                                     PERF_COUNT_HW_CACHE_RESULT_MISS)},
+};
+
+int openEvent(const EventSpec& spec, int tid) {
+  perf_event_attr attr;
+  std::memset(&attr, 0, sizeof(attr));
+  attr.size = sizeof(attr);
+  attr.type = spec.type;
+  attr.config = spec.config;
+  attr.disabled = 1;
+  attr.exclude_kernel = 1;
+  attr.exclude_hv = 1;
+  attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+  return (int)syscall(SYS_perf_event_open, &attr, tid, -1, -1, 0);
+}
+
+}  // namespace
+
+PerfCounters::PerfCounters(int tid) {
+  for (size_t e = 0; e < kEvents; ++e) {
+    fds_[e] = openEvent(kSpecs[e], tid);
+    if (fds_[e] < 0 && !*error_) error_ = std::strerror(errno);
+  }
+  if (available()) error_ = "";
+}
+
+PerfCounters::~PerfCounters() {
+  for (int fd : fds_)
+    if (fd >= 0) close(fd);
+}
+
+bool PerfCounters::available() const {
+  for (int fd : fds_)
+    if (fd >= 0) return true;
+  return false;
+}
+
+void PerfCounters::start() {
+  for (int fd : fds_) {
+    if (fd < 0) continue;
+    ioctl(fd, PERF_EVENT_IOC_RESET, 0);
+    ioctl(fd, PERF_EVENT_IOC_ENABLE, 0);
+  }
+}
+
+void PerfCounters::stop() {
+  for (size_t e = 0; e < kEvents; ++e) {
+    if (fds_[e] < 0) continue;
+    ioctl(fds_[e], PERF_EVENT_IOC_DISABLE, 0);
+
+    uint64_t v[3];  // value, time enabled, time running
+    if (read(fds_[e], v, sizeof(v)) != (ssize_t)sizeof(v) || v[2] == 0) continue;
+    totals_[e] += double(v[0]) * double(v[1]) / double(v[2]);
+  }
+}
+
+const char* PerfCounters::name(PerfEvent e) {
+  static const char* names[kEvents] = {"cycles",        "instructions", "l1d_misses",
+                                       "llc_misses",    "branch_misses", "dtlb_misses"};
+  return names[size_t(e)];
+}
@@ -1,262 +1,468 @@
 #include "Orderbook/Orderbook.hpp"
 
 #include <cstdio>
-#include <stdexcept>
 #include <utility>
 
+#include <sys/syscall.h>
+#include <unistd.h>
+
 #include "utils.hpp"
 
 
-/// @brief Orderbook matching function that uses map bid and ask levels to match orders
+/// @brief Orderbook matching function that walks the opposite side's price levels
 /// @param newOrder `OrderPointer` that is inserted into the matching engine
 void Orderbook::matchOrders(OrderPointer newOrder) {
   if (newOrder->getSide() == Side::Buy) {
-    while (true) {
-      if (asks_.empty() || newOrder->isFilled()) {
-        break;
-      }
-
-      auto& [bestAskPrice, asks] = *asks_.begin();
-
-      // Lazy cleanup of cancelled orders
-      if (!asks.front()->isValid()) [[unlikely]] {
-        auto cancelled = asks.front();
-        asks.pop_front();
-
-        if (asks.empty()) {
-          askLevels_.erase(bestAskPrice);
-          asks_.erase(asks_.begin());
-        }
-        orderPool_.release(cancelled);
-        continue;
-      }
-
-      if (newOrder->getPrice() < bestAskPrice) {
+    while (!asks_->empty() && !newOrder->isFilled()) {
+      const Price best = asks_->best();
+      if (newOrder->getPrice() < best) {
         break;
       }
 
-      Quantity fillQuantity =
-          std::min(newOrder->getQuantity(), asks.front()->getQuantity());
+      PriceLevel& level = *asks_->find(best);
+      Order* resting = level.front();
+      Quantity fillQuantity = std::min(newOrder->getQuantity(), resting->getQuantity());
 
-      onMatch(newOrder, asks.front(), fillQuantity);
+      onMatch(newOrder, resting, fillQuantity, best);
       newOrder->Fill(fillQuantity);
-      asks.front()->Fill(fillQuantity);
-      askLevels_[bestAskPrice] -= fillQuantity;
-
-      if (asks.front()->isFilled()) {
-        OrderPointer filled = asks.front();
-        orders_.erase(filled->getOrderId());
-        asks.pop_front();
-        size_--;
-        orderPool_.release(filled);
+      resting->Fill(fillQuantity);
+      asks_->reduce(best, level, fillQuantity);
+
+      if (resting->isFilled()) {
+        level.pop_front();
+        untrack(resting);
       }
 
-      if (asks.empty()) {
-        askLevels_.erase(bestAskPrice);
-        asks_.erase(asks_.begin());
+      if (level.empty()) {
+        asks_->remove(best);
       }
     }
   } else {
-    while (true) {
-      if (bids_.empty() || newOrder->isFilled()) {
+    while (!bids_->empty() && !newOrder->isFilled()) {
+      const Price best = bids_->best();
+      if (newOrder->getPrice() > best) {
         break;
       }
 
-      auto& [bestBidPrice, bids] = *bids_.begin();
-
-      // Lazy cleanup of cancelled orders
-      if (!bids.front()->isValid()) {
-        auto cancelled = bids.front();
-        bids.pop_front();
-        if (bids.empty()) {
-          bidLevels_.erase(bestBidPrice);
-          bids_.erase(bids_.begin());
-        }
-        orderPool_.release(cancelled);
-        continue;
-      }
-
-      if (newOrder->getPrice() > bestBidPrice) {
-        break;
-      }
-
-      Quantity fillQuantity =
-          std::min(newOrder->getQuantity(), bids.front()->getQuantity());
-
-      onMatch(bids.front(), newOrder, fillQuantity);
+      PriceLevel& level = *bids_->find(best);
+      Order* resting = level.front();
+      Quantity fillQuantity = std::min(newOrder->getQuantity(), resting->getQuantity());
 
+      onMatch(resting, newOrder, fillQuantity, best);
       newOrder->Fill(fillQuantity);
-      bids.front()->Fill(fillQuantity);
-      bidLevels_[bestBidPrice] -= fillQuantity;
-
-      if (bids.front()->isFilled()) {
-        OrderPointer filled = bids.front();
-        orders_.erase(filled->getOrderId());
-        bids.pop_front();
-        size_--;
-        orderPool_.release(filled);
+      resting->Fill(fillQuantity);
+      bids_->reduce(best, level, fillQuantity);
+
+      if (resting->isFilled()) {
+        level.pop_front();
+        untrack(resting);
       }
 
-      if (bids.empty()) {
-        bidLevels_.erase(bestBidPrice);
-        bids_.erase(bids_.begin());
+      if (level.empty()) {
+        bids_->remove(best);
       }
     }
   }
 };
 
-void Orderbook::addOrder(const Order& order) {
-  OrderPointer orderPtr = orderPool_.acquire(
-      order.getOrderId(), order.getOwner(), order.getOrderType(),
-      order.getPrice(), order.getQuantity(), order.getSide());
+OrderPointer Orderbook::addOrder(const OrderRequest& request) {
+  // FillOrKill: all or nothing, decided from the contra side's depth index
+  // before anything is touched, so a killed order costs no fills and no
+  // rollback
+  if (request.orderType == OrderType::FillOrKill) [[unlikely]] {
+    const Quantity available = request.side == Side::Buy ? asks_->depthTo(request.price)
+                                                         : bids_->depthTo(request.price);
+    if (available < request.quantity) {
+      onAck(request.orderId, request.owner, AckType::Cancelled);
+      return nullptr;
+    }
+  }
+
+  OrderPointer orderPtr = orderPool_->acquire(
+      request.orderId, request.owner, request.orderType,
+      request.price, request.quantity, request.side);
 
-  if (!orderPtr) {
-    throw std::runtime_error("Out of orders");
+  // pool at its hard limit: refuse the order, keep the engine running
+  if (!orderPtr) [[unlikely]] {
+    onAck(request.orderId, request.owner, AckType::Rejected);
+    return nullptr;
   }
 
   matchOrders(orderPtr);
 
   if (!orderPtr->isFilled() &&
-      order.getOrderType() == OrderType::GoodTillCancel) {
-    if (order.getSide() == Side::Buy) {
-      bids_[order.getPrice()].push_back(orderPtr);
-      bidLevels_[order.getPrice()] += order.getQuantity();
+      request.orderType == OrderType::GoodTillCancel) {
+    // the level's volume counts the remainder left after matching
+    if (request.side == Side::Buy) {
+      bids_->push(orderPtr);
     } else {
-      asks_[order.getPrice()].push_back(orderPtr);
-      askLevels_[order.getPrice()] += order.getQuantity();
+      asks_->push(orderPtr);
     }
 
-    orders_[order.getOrderId()] = orderPtr;
-    size_++;
-  } else {
-    orderPool_.release(orderPtr);
+    track(orderPtr);
+    onAck(request.orderId, request.owner, AckType::Accepted);
+    return orderPtr;
   }
-}
 
-void Orderbook::cancelOrder(const OrderId& orderId) {
-  if (orders_.count(orderId)) {
-    OrderPointer order = orders_[orderId];
-    Price price = order->getPrice();
-    Quantity qty = order->getQuantity();
+  // unfilled remainder of an immediate order is dropped, not rested
+  if (!orderPtr->isFilled())
+    onAck(request.orderId, request.owner, AckType::Cancelled);
+  orderPool_->release(orderPtr);
+  return nullptr;
+}
 
+void Orderbook::cancelOrder(const OrderRequest& request, bool notify) {
+  const OrderId orderId = request.orderId;
+  OrderPointer order = orders_.find(orderId);
+  if (order) {
     if (order->getSide() == Side::Buy) {
-      bidLevels_[price] -= qty;
-      if (bidLevels_[price] == 0) bidLevels_.erase(price);
-
-      if (bids_.count(price)) {
-        auto& list = bids_[price];
-        for (auto it = list.begin(); it != list.end(); ++it) {
-          if (*it == order) {
-            list.erase(it);
-            break;
-          }
-        }
-        if (list.empty()) bids_.erase(price);
-      }
+      bids_->erase(order);
     } else {
-      askLevels_[price] -= qty;
-      if (askLevels_[price] == 0) askLevels_.erase(price);
-
-      if (asks_.count(price)) {
-        auto& list = asks_[price];
-        for (auto it = list.begin(); it != list.end(); ++it) {
-          if (*it == order) {
-            list.erase(it);
-            break;
-          }
-        }
-        if (list.empty()) asks_.erase(price);
-      }
+      asks_->erase(order);
     }
 
     order->cancel();
+    untrack(order);
+    if (notify) onAck(orderId, request.owner, AckType::Cancelled);
+  } else if (notify) {
+    onAck(orderId, request.owner, AckType::Rejected);
+  }
+}
+
+void Orderbook::track(OrderPointer order) {
+  orders_.insert(order->getOrderId(), order);
+
+  // newest first, so linking never walks the list
+  order->ownerPrev_ = nullptr;
+  order->ownerNext_ = ownerHeads_.exchange(order->getOwner(), order);
+  if (order->ownerNext_) order->ownerNext_->ownerPrev_ = order;
+  size_++;
+}
+
+void Orderbook::untrack(OrderPointer order) {
+  orders_.erase(order->getOrderId());
 
-    orders_.erase(orderId);
+  if (order->ownerNext_) order->ownerNext_->ownerPrev_ = order->ownerPrev_;
+  if (order->ownerPrev_) {
+    order->ownerPrev_->ownerNext_ = order->ownerNext_;
+  } else if (order->ownerNext_) {
+    ownerHeads_.insert(order->getOwner(), order->ownerNext_);
+  } else {
+    ownerHeads_.erase(order->getOwner());
+  }
+  if (order->quoteLeg_) quoteLegs(order->getSide()).erase(order->getOwner());
+  size_--;
+  orderPool_->release(order);
+}
+
+void Orderbook::cancelAllForOwner(uint32_t owner) {
+  // one walk of the owner's list; the list itself is dropped as a whole
+  batchIds_.clear();
+  for (OrderPointer order = ownerHeads_.find(owner); order;) {
+    OrderPointer next = order->ownerNext_;
+    if (order->getSide() == Side::Buy) {
+      bids_->erase(order);
+    } else {
+      asks_->erase(order);
+    }
+    batchIds_.push_back(order->getOrderId());
+
+    order->cancel();
+    orders_.erase(order->getOrderId());
     size_--;
-    orderPool_.release(order);
+    orderPool_->release(order);
+    order = next;
+  }
+  ownerHeads_.erase(owner);
+  quoteBids_.erase(owner);
+  quoteAsks_.erase(owner);
+
+  if (cancelBatchListener_) {
+    CancelBatch batch{owner, batchIds_.data(), batchIds_.size()};
+    cancelBatchListener_(batch);
+  } else {
+    for (OrderId id : batchIds_) onAck(id, owner, AckType::Cancelled);
   }
 }
 
-void Orderbook::modifyOrder(const Order& order) {
-  this->cancelOrder(order.getOrderId());
-  this->addOrder(order);
+void Orderbook::modifyOrder(const OrderRequest& request) {
+  // Cutting size at the same price and side is done in place and keeps
+  // the order's queue position; anything else loses it by cancel/replace
+  OrderPointer resting = orders_.find(request.orderId);
+  if (resting && resting->getPrice() == request.price &&
+      resting->getSide() == request.side &&
+      resting->getOrderType() == request.orderType && request.quantity > 0 &&
+      request.quantity <= resting->getQuantity()) {
+    if (resting->getSide() == Side::Buy) {
+      bids_->shrink(resting, request.quantity);
+    } else {
+      asks_->shrink(resting, request.quantity);
+    }
+    onAck(request.orderId, request.owner, AckType::Accepted);
+    return;
+  }
+
+  // the replacement reports for itself; the removed original stays silent
+  this->cancelOrder(request, false);
+  this->addOrder(request);
+}
+
+void Orderbook::quote(const OrderRequest& request) {
+  // the request's own order fields are the bid
+  const uint32_t owner = request.owner;
+  const QuoteLeg& ask = request.ask;
+  if (request.quantity > 0 && ask.quantity > 0 && request.price >= ask.price) [[unlikely]] {
+    // a crossed quote would trade with itself: refuse both legs
+    onAck(request.orderId, owner, AckType::Rejected);
+    onAck(ask.orderId, owner, AckType::Rejected);
+    return;
+  }
+
+  // Both old legs are settled before either new one is placed, so a new
+  // leg never matches against its owner's previous quote
+  OrderPointer keptBid = keepQuoteLeg(Side::Buy, owner, request.price, request.quantity);
+  OrderPointer keptAsk = keepQuoteLeg(Side::Sell, owner, ask.price, ask.quantity);
+
+  placeQuoteLeg(keptBid, {RequestType::Add, Order(request.orderId, owner, OrderType::GoodTillCancel,
+                                                  request.price, request.quantity, Side::Buy)});
+  placeQuoteLeg(keptAsk, {RequestType::Add, Order(ask.orderId, owner, OrderType::GoodTillCancel,
+                                                  ask.price, ask.quantity, Side::Sell)});
+}
+
+OrderPointer Orderbook::keepQuoteLeg(Side side, uint32_t owner, Price price, Quantity quantity) {
+  // The resting leg stays, with its queue position, when the new one is at
+  // the same price and no bigger; otherwise it is cancelled
+  OrderPointer leg = quoteLegs(side).find(owner);
+  if (!leg) return nullptr;
+  if (quantity > 0 && leg->getPrice() == price && quantity <= leg->getQuantity()) return leg;
+
+  if (side == Side::Buy) {
+    bids_->erase(leg);
+  } else {
+    asks_->erase(leg);
+  }
+  const OrderId legId = leg->getOrderId();
+  leg->cancel();
+  untrack(leg);
+  onAck(legId, owner, AckType::Cancelled);
+  return nullptr;
+}
+
+void Orderbook::placeQuoteLeg(OrderPointer kept, const OrderRequest& leg) {
+  if (kept) {
+    // The old id stays live and is acked with its new size; the new id is
+    // never placed, so it is answered Cancelled
+    if (leg.side == Side::Buy) {
+      bids_->shrink(kept, leg.quantity);
+    } else {
+      asks_->shrink(kept, leg.quantity);
+    }
+    onAck(kept->getOrderId(), leg.owner, AckType::Accepted);
+    onAck(leg.orderId, leg.owner, AckType::Cancelled);
+    return;
+  }
+  if (leg.quantity == 0) return;  // side withdrawn
+
+  if (OrderPointer rested = addOrder(leg)) {
+    rested->quoteLeg_ = true;
+    quoteLegs(leg.side).insert(leg.owner, rested);
+  }
 }
 
 void Orderbook::submitRequest(OrderRequest& request) {
-  buffer_.push(std::move(request));
+#ifdef OB_ENABLE_LATENCY
+  request.submitTsc = rdtsc();
+#endif
+
+  if (mode_ == EngineMode::Inline) {
+    processRequest(request);
+#ifdef OB_ENABLE_LATENCY
+    recordLatency(request, request.submitTsc);
+#endif
+    return;
+  }
+  buffer_->push(std::move(request));
 }
 
-void Orderbook::processLoop() {
-  while (true) {
-    OrderRequest request = buffer_.pop();
-    switch (request.type) {
-      case (RequestType::Add):
-        this->addOrder(request.order);
-        break;
+void Orderbook::processRequest(const OrderRequest& request) {
+  switch (request.type) {
+    case (RequestType::Add):
+      this->addOrder(request);
+      break;
 
-      case (RequestType::Cancel):
-        this->cancelOrder(request.order.getOrderId());
-        break;
+    case (RequestType::Cancel):
+      this->cancelOrder(request);
+      break;
 
-      case (RequestType::Modify):
-        this->modifyOrder(request.order);
-        break;
+    case (RequestType::Modify):
+      this->modifyOrder(request);
+      break;
+
+    case (RequestType::CancelAllForOwner):
+      this->cancelAllForOwner(request.owner);
+      break;
+
+    case (RequestType::Quote):
+      this->quote(request);
+      break;
 
 #ifdef OB_ENABLE_UI
-      case (RequestType::Snapshot):
-        this->takeSnapshot();
-        break;
+    case (RequestType::Snapshot):
+      this->takeSnapshot();
+      break;
 #endif
 
-      case (RequestType::Stop):
-        return;
+    default:
+      break;
+  }
+
+  if (quoteListener_) publishQuote();
+
+  // single writer: a plain store, no read-modify-write
+  processed_.store(processed_.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+}
+
+void Orderbook::processLoop(size_t maxOrders, int coreId, size_t prefaultThreads) {
+  int numaNode = -1;
+  if (coreId >= 0) {
+    int rc = pinThread(pthread_self(), coreId);
+    if (rc != 0) {
+      std::fprintf(stderr, "Error calling pthread_setaffinity_np: %d\n", rc);
+    } else {
+      // prefault helpers and the pool's slab grower run anywhere: give the
+      // arenas this core's node so their first touch stays local
+      numaNode = currentNumaNode();
     }
   }
+
+  try {
+    initEngine(maxOrders, numaNode, prefaultThreads);
+  } catch (...) {
+    initError_ = std::current_exception();
+    workerTid_.store(-1, std::memory_order_release);
+    return;
+  }
+  workerTid_.store((int)syscall(SYS_gettid), std::memory_order_release);
+
+  while (true) {
+    OrderRequest request = buffer_->pop();
+    if (request.type == RequestType::Stop) [[unlikely]] return;
+#ifdef OB_ENABLE_LATENCY
+    const uint64_t dequeued = rdtsc();
+    processRequest(request);
+    recordLatency(request, dequeued);
+#else
+    processRequest(request);
+#endif
+  }
+}
+
+int Orderbook::matchingThreadId() const {
+  return workerTid_.load(std::memory_order_acquire);
 }
 
 Price Orderbook::topBidPrice() const {
-  if (bids_.empty()) return 0;
-  return bids_.begin()->first;
+  if (bids_->empty()) return 0;
+  return bids_->best();
 }
 
 Price Orderbook::topAskPrice() const {
-  if (asks_.empty()) return 0;
-  return asks_.begin()->first;
+  if (asks_->empty()) return 0;
+  return asks_->best();
+}
+
+Quantity Orderbook::depthTo(Side side, Price limit) const {
+  return side == Side::Buy ? bids_->depthTo(limit) : asks_->depthTo(limit);
+}
+
+std::optional<Price> Orderbook::priceFor(Side side, Quantity quantity) const {
+  SweepCost cost = side == Side::Buy ? bids_->sweep(quantity) : asks_->sweep(quantity);
+  if (cost.quantity < quantity) return std::nullopt;
+  return cost.worst;
 }
 
-inline void Orderbook::onMatch(const OrderPointer& b, const OrderPointer& a, Quantity& qty) {
+std::optional<double> Orderbook::sweepVwap(Side side, Quantity quantity) const {
+  SweepCost cost = side == Side::Buy ? bids_->sweep(quantity) : asks_->sweep(quantity);
+  if (cost.quantity < quantity) return std::nullopt;
+  return cost.vwap();
+}
+
+inline void Orderbook::onMatch(const OrderPointer& b, const OrderPointer& a, Quantity& qty, Price price) {
   matchedTrades_++;
+  matchedVolume_ += qty;
 
 #ifdef OB_ENABLE_UI
-  recordTradePrice(a->getPrice(), qty);
+  recordTradePrice(price, qty);
 #endif
 
   if (listener_) [[likely]] {
-    Trade t{b, a, qty};
+    Trade t{b, a, qty, price};
     listener_(t);
   }
 }
 
-Orderbook::Orderbook(size_t maxOrders, int coreId)
-    : orderPool_(maxOrders),
-      buffer_(nextPowerOf2(maxOrders)) {
-  workerThread_ = std::thread(&Orderbook::processLoop, this);
+inline void Orderbook::onAck(OrderId orderId, uint32_t owner, AckType type) {
+  if (ackListener_) {
+    Ack ack{orderId, owner, type};
+    ackListener_(ack);
+  }
+}
 
-  if (coreId >= 0) {
-    cpu_set_t cpuset;
-    CPU_ZERO(&cpuset);
-    CPU_SET(coreId, &cpuset);
+#ifdef OB_ENABLE_LATENCY
+inline void Orderbook::recordLatency(const OrderRequest& request, uint64_t dequeued) {
+  const uint64_t done = rdtsc();
+  RequestLatency& lat = (*latency_)[request.type];
+  lat.queue.record(dequeued - request.submitTsc);
+  lat.service.record(done - dequeued);
+  lat.total.record(done - request.submitTsc);
+}
+#endif
 
-    int rc = pthread_setaffinity_np(workerThread_.native_handle(),
-                                    sizeof(cpu_set_t), &cpuset);
+inline void Orderbook::publishQuote() {
+  Quote q{topBidPrice(), topAskPrice()};
+  if (q.bid != lastQuote_.bid || q.ask != lastQuote_.ask) {
+    lastQuote_ = q;
+    quoteListener_(q);
+  }
+}
 
-    if (rc != 0) {
-      std::fprintf(stderr, "Error calling pthread_setaffinity_np: %d\n", rc);
-    }
+Orderbook::Orderbook(size_t maxOrders, int coreId, EngineMode mode, size_t prefaultThreads)
+    : mode_(mode) {
+  if (mode_ == EngineMode::Inline) {
+    initEngine(maxOrders, -1, prefaultThreads);
+    return;
+  }
+
+  // The worker pins itself, then maps (and optionally prefaults) the engine
+  // memory; requests can only be accepted once the ring exists.
+  workerThread_ = std::thread(&Orderbook::processLoop, this, maxOrders, coreId, prefaultThreads);
+  while (workerTid_.load(std::memory_order_acquire) == 0) std::this_thread::yield();
+
+  if (initError_) {
+    workerThread_.join();
+    std::rethrow_exception(initError_);
   }
 }
 
+void Orderbook::initEngine(size_t maxOrders, int numaNode, size_t prefaultThreads) {
+  // a threaded engine never maps pool slabs on the matching thread
+  orderPool_.emplace(maxOrders, numaNode, mode_ == EngineMode::Threaded);
+  if (mode_ == EngineMode::Threaded) buffer_.emplace(nextPowerOf2(maxOrders), numaNode);
+  bids_.emplace(numaNode);
+  asks_.emplace(numaNode);
+
+  if (prefaultThreads > 0) {
+    orderPool_->prefault(prefaultThreads);
+    if (buffer_) buffer_->prefault(prefaultThreads);
+  }
+#ifdef OB_ENABLE_LATENCY
+  latency_ = std::make_unique<LatencyStats>();
+#endif
+}
+
 Orderbook::~Orderbook() {
+  if (mode_ == EngineMode::Inline) return;
+
   OrderRequest stop;
   stop.type = RequestType::Stop;
 
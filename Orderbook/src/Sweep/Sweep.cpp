@@ -0,0 +1,108 @@
+#include "Sweep/Sweep.hpp"
+
+#include <chrono>
+#include <limits>
+#include <memory>
+
+#include "Scheduler/WorkStealingPool.hpp"
+#include "Trader/MomentumTrader.hpp"
+#include "Trader/TraderManager.hpp"
+#include "Trader/WhaleTrader.hpp"
+#include "utils.hpp"
+
+std::vector<SweepPoint> expandGrid(const SweepGrid& grid) {
+  std::vector<SweepPoint> points;
+  for (int noise : grid.noiseTraders)
+    for (int whales : grid.whaleTraders)
+      for (int momentum : grid.momentumTraders)
+        for (int ps : grid.priceSpread)
+          for (int qs : grid.qtySpread)
+            for (int mp : grid.makerP)
+              for (uint64_t seed : grid.seeds) {
+                SweepPoint p;
+                p.noiseTraders = noise;
+                p.whaleTraders = whales;
+                p.momentumTraders = momentum;
+                p.noise = NoiseTraderParams{ps, qs, mp};
+                p.seed = seed;
+                p.rounds = grid.rounds;
+                p.maxOrders = grid.maxOrders;
+                points.push_back(p);
+              }
+  return points;
+}
+
+SweepResult runSimulation(const SweepPoint& point) {
+  SweepResult result;
+  result.point = point;
+
+  const size_t population =
+      size_t(point.noiseTraders + point.whaleTraders + point.momentumTraders);
+  const size_t capacity =
+      point.maxOrders ? point.maxOrders
+                      : nextPowerOf2(population * Config::maxOrdersPerTrader + 1);
+
+  auto start = std::chrono::steady_clock::now();
+
+  Orderbook ob(capacity, -1, EngineMode::Inline);
+  TraderManager mgr(ob);
+
+  const uint64_t infiniteCash = std::numeric_limits<uint64_t>::max();
+  uint32_t id = 1;
+  for (int i = 0; i < point.noiseTraders; ++i)
+    mgr.addTrader(std::make_shared<NoiseTrader>(id++, infiniteCash, ob, point.noise, point.seed));
+  for (int i = 0; i < point.whaleTraders; ++i)
+    mgr.addTrader(std::make_shared<WhaleTrader>(id++, infiniteCash, ob));
+  for (int i = 0; i < point.momentumTraders; ++i)
+    mgr.addTrader(std::make_shared<MomentumTrader>(id++, infiniteCash, ob));
+
+  double spreadSum = 0;
+  uint64_t spreadSamples = 0;
+
+  for (size_t r = 0; r < point.rounds; ++r) {
+    mgr.step();
+
+    Price tb = ob.topBidPrice();
+    Price ta = ob.topAskPrice();
+    if (tb != 0 && ta != 0) {
+      spreadSum += double(ta) - double(tb);
+      ++spreadSamples;
+    }
+  }
+
+  result.trades = ob.matchedTrades();
+  result.volume = ob.matchedVolume();
+  result.avgSpread = spreadSamples ? spreadSum / double(spreadSamples) : 0;
+  result.restingOrders = ob.size();
+
+  std::chrono::duration<double, std::milli> elapsed =
+      std::chrono::steady_clock::now() - start;
+  result.runtimeMs = elapsed.count();
+
+  return result;
+}
+
+std::vector<SweepResult> runSweep(const std::vector<SweepPoint>& points,
+                                  size_t threads) {
+  std::vector<SweepResult> results(points.size());
+  WorkStealingPool pool(threads);
+  pool.run(points.size(),
+           [&](size_t i) { results[i] = runSimulation(points[i]); });
+  return results;
+}
+
+void writeCsv(std::ostream& out, const std::vector<SweepResult>& results) {
+  out << "run,noise_traders,whale_traders,momentum_traders,price_spread,qty_spread,maker_p,seed,"
+         "rounds,trades,volume,avg_spread,resting_orders,runtime_ms\n";
+
+  for (size_t i = 0; i < results.size(); ++i) {
+    const SweepResult& r = results[i];
+    const SweepPoint& p = r.point;
+    out << i << ',' << p.noiseTraders << ',' << p.whaleTraders << ','
+        << p.momentumTraders << ','
+        << p.noise.priceSpread << ',' << p.noise.qtySpread << ','
+        << p.noise.makerP << ',' << p.seed << ',' << p.rounds << ','
+        << r.trades << ',' << r.volume << ',' << r.avgSpread << ','
+        << r.restingOrders << ',' << r.runtimeMs << '\n';
+  }
+}
@@ -0,0 +1,281 @@
+#include "Trader/CoScheduler.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <functional>
+#include <queue>
+
+#include "Scheduler/EventSignal.hpp"
+#include "Scheduler/SpscQueue.hpp"
+#include "utils.hpp"
+
+/* -------------------------------------------------------------------------- */
+/*                                   Worker                                   */
+/* -------------------------------------------------------------------------- */
+
+struct CoWorker {
+  struct Timer {
+    int64_t deadline;
+    CoTrader* agent;
+    bool operator>(const Timer& o) const { return deadline > o.deadline; }
+  };
+
+  EventSignal signal;
+
+  // Filled by the matching thread, drained by the worker
+  SpscQueue<CoEvent> inbox{1024};
+
+  std::vector<CoTrader*> agents;  // home agents, resumed once at start
+  std::vector<CoTrader*> ready;
+  std::vector<CoTrader*> running;
+  std::vector<CoTrader*> quoteWaiters;
+  std::atomic<bool> wantsQuotes{false};
+  uint64_t seenQuoteSeq{0};
+  std::priority_queue<Timer, std::vector<Timer>, std::greater<Timer>> timers;
+
+  std::atomic<uint64_t> resumes{0};
+};
+
+/* -------------------------------------------------------------------------- */
+/*                                 Awaitables                                 */
+/* -------------------------------------------------------------------------- */
+
+void CoTrader::QuoteAwaiter::await_suspend(std::coroutine_handle<>) {
+  self->waiting_ = Wait::Quote;
+  self->worker_->quoteWaiters.push_back(self);
+  // seq_cst pairs with the quote listener: either it sees this flag or the
+  // worker sees the new sequence number before going to sleep
+  self->worker_->wantsQuotes.store(true, std::memory_order_seq_cst);
+}
+
+void CoTrader::FillAwaiter::await_suspend(std::coroutine_handle<>) {
+  self->waiting_ = Wait::Fill;
+}
+
+Fill CoTrader::FillAwaiter::await_resume() {
+  Fill f = self->fills_.front();
+  self->fills_.pop_front();
+  return f;
+}
+
+bool CoTrader::AckAwaiter::await_ready() const noexcept {
+  for (auto& [id, type] : self->acks_)
+    if (id == orderId) return true;
+  return false;
+}
+
+void CoTrader::AckAwaiter::await_suspend(std::coroutine_handle<>) {
+  self->waiting_ = Wait::Ack;
+  self->waitId_ = orderId;
+}
+
+AckType CoTrader::AckAwaiter::await_resume() {
+  auto& acks = self->acks_;
+  for (auto it = acks.begin(); it != acks.end(); ++it) {
+    if (it->first == orderId) {
+      AckType type = it->second;
+      acks.erase(it);
+      return type;
+    }
+  }
+  return AckType::Rejected;
+}
+
+void CoTrader::TimerAwaiter::await_suspend(std::coroutine_handle<>) {
+  self->waiting_ = Wait::Timer;
+  self->worker_->timers.push({nowNs() + delay.count(), self});
+}
+
+/* -------------------------------------------------------------------------- */
+/*                                   Agent                                    */
+/* -------------------------------------------------------------------------- */
+
+OrderId CoTrader::placeOrder(OrderType type, Price price, Quantity qty, Side side) {
+  OrderId id = scheduler_->nextOrderId(idLease_);
+  Order order{id, traderId_, type, price, qty, side};
+  OrderRequest req{RequestType::Add, order};
+  ob_.submitRequest(req);
+  return id;
+}
+
+void CoTrader::cancelOrder(OrderId id) {
+  Order order(id, traderId_, OrderType::GoodTillCancel, 0, 0, Side::Buy);
+  OrderRequest req{RequestType::Cancel, order};
+  ob_.submitRequest(req);
+}
+
+bool CoTrader::deliver(const CoEvent& e) {
+  if (e.isFill) {
+    const Fill& f = e.fill;
+    if (f.side == Side::Buy) {
+      stock_ += (int64_t)f.qty;
+      cash_ -= (int64_t)(f.price * f.qty);
+    } else {
+      stock_ -= (int64_t)f.qty;
+      cash_ += (int64_t)(f.price * f.qty);
+    }
+
+    if (fills_.size() == maxPendingEvents) fills_.pop_front();
+    fills_.push_back(f);
+    return waiting_ == Wait::Fill;
+  }
+
+  if (acks_.size() == maxPendingEvents) acks_.pop_front();
+  acks_.push_back({e.fill.orderId, e.ack});
+  return waiting_ == Wait::Ack && waitId_ == e.fill.orderId;
+}
+
+/* -------------------------------------------------------------------------- */
+/*                                 Scheduler                                  */
+/* -------------------------------------------------------------------------- */
+
+CoScheduler::CoScheduler(Orderbook& ob, size_t workers, int firstCore)
+    : ob_(ob), running_(false), firstCore_(firstCore) {
+  if (workers == 0) workers = std::max<size_t>(1, std::thread::hardware_concurrency());
+  for (size_t w = 0; w < workers; ++w) workers_.push_back(std::make_unique<CoWorker>());
+
+  // Everything below runs on the matching thread: keep it to a queue push
+  // and a futex poke, all agent logic happens on the workers.
+  ob_.setTradeListener([this](Trade& t) {
+    uint32_t buyer = t.bid->getOwner();
+    uint32_t seller = t.ask->getOwner();
+    if (CoTrader* a = agentFor(buyer))
+      post(a, CoEvent{a, true, Fill{t.bid->getOrderId(), Side::Buy, t.price, t.qty}, AckType::Accepted});
+    if (CoTrader* a = agentFor(seller))
+      post(a, CoEvent{a, true, Fill{t.ask->getOrderId(), Side::Sell, t.price, t.qty}, AckType::Accepted});
+  });
+
+  ob_.setAckListener([this](Ack& ack) {
+    if (ack.type == AckType::Accepted) return;
+    if (CoTrader* a = agentFor(ack.owner))
+      post(a, CoEvent{a, false, Fill{ack.orderId, Side::Buy, 0, 0}, ack.type});
+  });
+
+  ob_.setQuoteListener([this](Quote& q) {
+    quoteBid_.store(q.bid, std::memory_order_relaxed);
+    quoteAsk_.store(q.ask, std::memory_order_relaxed);
+    quoteSeq_.fetch_add(1, std::memory_order_seq_cst);
+    for (auto& w : workers_)
+      if (w->wantsQuotes.load(std::memory_order_seq_cst)) w->signal.notify();
+  });
+}
+
+CoScheduler::~CoScheduler() {
+  ob_.setTradeListener(nullptr);
+  ob_.setAckListener(nullptr);
+  ob_.setQuoteListener(nullptr);
+  stop();
+  join();
+}
+
+void CoScheduler::spawn(std::shared_ptr<CoTrader> agent) {
+  CoWorker& w = *workers_[agents_.size() % workers_.size()];
+  agent->scheduler_ = this;
+  agent->worker_ = &w;
+  agent->task_ = agent->run();
+  w.agents.push_back(agent.get());
+
+  uint32_t id = agent->getId();
+  if (id >= byOwner_.size()) byOwner_.resize(id + 1, nullptr);
+  byOwner_[id] = agent.get();
+  agents_.push_back(std::move(agent));
+}
+
+void CoScheduler::start() {
+  running_ = true;
+  for (size_t w = 0; w < workers_.size(); ++w) {
+    threads_.emplace_back(&CoScheduler::workerLoop, this, std::ref(*workers_[w]));
+
+    if (firstCore_ >= 0) {
+      int rc = pinThread(threads_.back().native_handle(), firstCore_ + (int)w);
+      if (rc != 0) {
+        std::fprintf(stderr, "Error calling pthread_setaffinity_np: %d\n", rc);
+      }
+    }
+  }
+}
+
+void CoScheduler::stop() {
+  running_.store(false);
+  for (auto& a : agents_) a->stop();
+  for (auto& w : workers_) w->signal.notify();
+}
+
+void CoScheduler::join() {
+  for (auto& th : threads_) if (th.joinable()) th.join();
+  threads_.clear();
+}
+
+uint64_t CoScheduler::resumes() const {
+  uint64_t total = 0;
+  for (auto& w : workers_) total += w->resumes.load(std::memory_order_relaxed);
+  return total;
+}
+
+void CoScheduler::post(CoTrader* agent, const CoEvent& e) {
+  CoWorker& w = *agent->worker_;
+  w.inbox.push(e);
+  w.signal.notify();
+}
+
+void CoScheduler::workerLoop(CoWorker& w) {
+  w.seenQuoteSeq = quoteSeq_.load(std::memory_order_acquire);
+  w.ready = w.agents;
+
+  while (running_.load(std::memory_order_acquire)) {
+    uint32_t seen = w.signal.prepare();
+
+    // 1. fills and acks from the matching thread
+    w.inbox.drain([&w](const CoEvent& e) {
+      CoTrader* a = e.agent;
+      if (a->deliver(e)) {
+        a->waiting_ = CoTrader::Wait::None;
+        w.ready.push_back(a);
+      }
+    });
+
+    // 2. quote change: wake everyone waiting for it at once
+    uint64_t qs = quoteSeq_.load(std::memory_order_seq_cst);
+    if (qs != w.seenQuoteSeq && !w.quoteWaiters.empty()) {
+      w.seenQuoteSeq = qs;
+      Quote q{quoteBid_.load(std::memory_order_relaxed),
+              quoteAsk_.load(std::memory_order_relaxed)};
+      for (CoTrader* a : w.quoteWaiters) {
+        a->quote_ = q;
+        a->waiting_ = CoTrader::Wait::None;
+        w.ready.push_back(a);
+      }
+      w.quoteWaiters.clear();
+      w.wantsQuotes.store(false, std::memory_order_relaxed);
+    } else {
+      w.seenQuoteSeq = qs;
+    }
+
+    // 3. expired timers
+    int64_t now = nowNs();
+    while (!w.timers.empty() && w.timers.top().deadline <= now) {
+      CoTrader* a = w.timers.top().agent;
+      w.timers.pop();
+      if (a->waiting_ == CoTrader::Wait::Timer) {
+        a->waiting_ = CoTrader::Wait::None;
+        w.ready.push_back(a);
+      }
+    }
+
+    if (w.ready.empty()) {
+      int64_t timeout = w.timers.empty() ? -1 : std::max<int64_t>(0, w.timers.top().deadline - now);
+      w.signal.wait(seen, timeout);
+      continue;
+    }
+
+    // 4. resume; agents suspending again re-register themselves
+    std::swap(w.ready, w.running);
+    for (CoTrader* a : w.running) {
+      if (!a->isRunning() || a->task_.done()) continue;
+      a->task_.resume();
+      w.resumes.fetch_add(1, std::memory_order_relaxed);
+    }
+    w.running.clear();
+  }
+}
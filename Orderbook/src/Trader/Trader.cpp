@@ -1,45 +1,111 @@
 #include "Trader/Trader.hpp"
 
+#include <algorithm>
+
 #include "Trader/TraderManager.hpp"
 
 OrderId Trader::placeOrder(OrderType type, Price price, Quantity qty, Side side) {
-  OrderId id = manager_->nextOrderId();
+  OrderId id = manager_->nextOrderId(idLease_);
   Order order{id, traderId_, type, price, qty, side};
   OrderRequest req{RequestType::Add, order};
   ob_.submitRequest(req);
-  orders_.push_back(id);
-  orderIndex_[id] = orders_.size() - 1;
-  if (side == Side::Buy) {
-    reservedCash_ += price * qty;
-  } else {
-    reservedStock_ += qty;
-  }
+  orders_.insert({id, price, qty, 0, side, OrderState::Pending, false, 0, 0, side, 0});
+  reserve(side, price, qty);
   return id;
 }
 
-void Trader::cancelOrder(OrderId id) {
+bool Trader::cancelOrder(OrderId id) {
+  TrackedOrder* tracked = orders_.find(id);
+  if (!tracked || tracked->cancelSent) return false;
+
   Order order(id, traderId_, OrderType::GoodTillCancel, 0, 0, Side::Buy);
   OrderRequest req{RequestType::Cancel, order};
   ob_.submitRequest(req);
-
-    auto itIdx = orderIndex_.find(id);
-  if (itIdx != orderIndex_.end()) {
-    size_t idx = itIdx->second;
-    size_t last = orders_.size() - 1;
-    if (idx != last) {
-      // swap with last and update index map (O(1) removal)
-      OrderId swapped = orders_[last];
-      orders_[idx] = swapped;
-      orderIndex_[swapped] = idx;
-    }
-    orders_.pop_back();
-    orderIndex_.erase(itIdx);
-  }
+  tracked->cancelSent = true;
+  return true;
 }
 
-void Trader::modifyOrder(OrderId id, OrderType type, Price price, Quantity qty,
+bool Trader::modifyOrder(OrderId id, OrderType type, Price price, Quantity qty,
                          Side side) {
+  // settle what has already been reported, so the release below only
+  // covers quantity that has not filled
+  applyReports();
+  TrackedOrder* tracked = orders_.find(id);
+  if (!tracked || tracked->cancelSent || tracked->staleAcks) return false;
+
   Order order(id, traderId_, type, price, qty, side);
   OrderRequest req{RequestType::Modify, order};
   ob_.submitRequest(req);
+
+  // The engine replaces the order, so it starts over as a fresh one. The
+  // old one keeps its reservation until the engine has answered the
+  // modify, as some of it may still fill before then.
+  reserve(side, price, qty);
+  const uint8_t staleAcks = tracked->state == OrderState::Pending ? 2 : 1;
+  *tracked = {id, price, qty, 0, side, OrderState::Pending, false,
+              tracked->price, tracked->remaining(), tracked->side, staleAcks};
+  return true;
+}
+
+void Trader::reserve(Side side, Price price, Quantity qty) {
+  if (side == Side::Buy) {
+    reservedCash_ += price * qty;
+  } else {
+    reservedStock_ += qty;
+  }
+}
+
+void Trader::release(Side side, Price price, Quantity qty) {
+  if (side == Side::Buy) {
+    reservedCash_ -= price * qty;
+  } else {
+    reservedStock_ -= qty;
+  }
+}
+
+void Trader::releaseStale(TrackedOrder& order) {
+  release(order.staleSide, order.stalePrice, order.stale);
+  order.stale = 0;
+}
+
+void Trader::applyReports() {
+  reports_.drain([this](const ExecReport& r) { applyReport(r); });
+}
+
+void Trader::applyReport(const ExecReport& r) {
+  TrackedOrder* o = orders_.find(r.orderId);
+  if (!o) return;  // already terminal
+
+  if (r.isFill) {
+    if (o->stale && r.price == o->stalePrice) {
+      // the replaced incarnation (onTrade() has released it); once it has
+      // filled in full it will not be acked either
+      o->stale -= std::min(o->stale, r.qty);
+      if (!o->stale && o->staleAcks > 1) o->staleAcks = 1;
+      return;
+    }
+    o->filled += r.qty;
+    o->state = o->filled >= o->qty ? OrderState::Filled : OrderState::PartiallyFilled;
+  } else {
+    if (o->staleAcks && --o->staleAcks) {
+      // the replaced incarnation's own ack; unless it rested, it is done
+      if (r.ack != AckType::Accepted) releaseStale(*o);
+      return;
+    }
+    releaseStale(*o);  // the modify has been applied: nothing older can fill
+
+    if (r.ack == AckType::Accepted) {
+      if (o->state == OrderState::Pending) o->state = OrderState::Live;
+    } else {
+      // Cancelled, or Rejected because the book refused it or it no longer
+      // exists there: either way nothing more will fill
+      release(o->side, o->price, o->remaining());
+      o->state = OrderState::Cancelled;
+    }
+  }
+
+  if (o->state == OrderState::Filled || o->state == OrderState::Cancelled) {
+    releaseStale(*o);
+    orders_.erase(r.orderId);
+  }
 }
@@ -0,0 +1,313 @@
+#include "Trader/TraderManager.hpp"
+
+#include <algorithm>
+#include <functional>
+#include <queue>
+
+#include "Scheduler/EventSignal.hpp"
+#include "Scheduler/WorkStealingDeque.hpp"
+#include "utils.hpp"
+
+/* -------------------------------------------------------------------------- */
+/*                                   Worker                                   */
+/* -------------------------------------------------------------------------- */
+
+namespace {
+constexpr uint8_t kQueued = 1 << 0;  // a task for this trader is in some deque or running
+constexpr uint8_t kRerun = 1 << 1;   // woken again while queued: run once more
+}  // namespace
+
+struct TraderWorker {
+  struct Timer {
+    int64_t deadline;
+    Trader* trader;
+    bool operator>(const Timer& o) const { return deadline > o.deadline; }
+  };
+
+  EventSignal signal;
+  std::atomic<bool> sleeping{false};
+
+  // Intrusive MPSC stack of traders woken by the dispatcher (Trader::nextReady_)
+  std::atomic<Trader*> inbox{nullptr};
+
+  // Tick tasks; sized at start() to hold every trader once
+  std::unique_ptr<WorkStealingDeque<Trader*>> tasks;
+
+  std::vector<Trader*> members;
+  std::vector<Trader*> quoteSubs;
+  std::vector<Trader*> tradeSubs;
+  bool wantsQuotes{false};  // fixed once started
+  bool wantsTrades{false};
+  uint64_t seenQuote{0};
+  uint64_t seenTrade{0};
+
+  // Entries whose deadline no longer matches Trader::nextTimer_ are stale
+  std::priority_queue<Timer, std::vector<Timer>, std::greater<Timer>> timers;
+
+  size_t pushed{0};  // tasks queued in the current round
+  std::atomic<uint64_t> ticks{0};
+};
+
+/* -------------------------------------------------------------------------- */
+/*                                  Manager                                   */
+/* -------------------------------------------------------------------------- */
+
+TraderManager::TraderManager(Orderbook& ob, size_t sleepUs)
+    : ob_(ob), running_(false), sleepUs_(sleepUs) {
+  size_t workerCount = std::max<size_t>(1, std::thread::hardware_concurrency());
+  for (size_t w = 0; w < workerCount; ++w)
+    workers_.push_back(std::make_unique<TraderWorker>());
+
+  // forward trades from the orderbook to only the involved traders (one
+  // indexed load per side)
+  ob_.setTradeListener([this](Trade& t) {
+    const uint32_t buyer = t.bid->getOwner();
+    const uint32_t seller = t.ask->getOwner();
+
+    // Bid Side onTrade()
+    if (Trader* b = tradersById_.find(buyer)) {
+      b->onTrade(t);
+      wake(b);
+    }
+    // Ask side onTrade()
+    if (seller != buyer) {
+      if (Trader* a = tradersById_.find(seller)) {
+        a->onTrade(t);
+        wake(a);
+      }
+    }
+
+    tape_.append(t.price, t.qty);
+    tradeSeq_.fetch_add(1, std::memory_order_release);
+    for (auto& w : workers_)
+      if (w->wantsTrades) w->signal.notify();
+  });
+
+  // acks only feed the owner's order table; they never wake anyone
+  ob_.setAckListener([this](Ack& ack) {
+    if (Trader* t = tradersById_.find(ack.owner)) t->onAck(ack);
+  });
+
+  ob_.setQuoteListener([this](Quote&) {
+    quoteSeq_.fetch_add(1, std::memory_order_release);
+    for (auto& w : workers_)
+      if (w->wantsQuotes) w->signal.notify();
+  });
+}
+
+TraderManager::~TraderManager() {
+  // unregister listeners to avoid callbacks into a destructed manager
+  ob_.setTradeListener(nullptr);
+  ob_.setAckListener(nullptr);
+  ob_.setQuoteListener(nullptr);
+  stop();
+  join();
+}
+
+void TraderManager::addTrader(std::shared_ptr<Trader> t) {
+  t->setManager(this);
+  t->tape_ = &tape_;
+  t->tapeCursor_ = tape_.head();
+
+  t->worker_ = traders_.size() % workers_.size();
+  TraderWorker& w = *workers_[t->worker_];
+  w.members.push_back(t.get());
+  if (t->wakeEvents() & WakeOnQuote) {
+    w.quoteSubs.push_back(t.get());
+    w.wantsQuotes = true;
+  }
+  if (t->wakeEvents() & WakeOnTrade) {
+    w.tradeSubs.push_back(t.get());
+    w.wantsTrades = true;
+  }
+
+  tradersById_.set(t->getId(), t.get());
+  traders_.push_back(std::move(t));
+}
+
+void TraderManager::start() {
+  running_ = true;
+
+  for (auto& w : workers_)
+    w->tasks = std::make_unique<WorkStealingDeque<Trader*>>(nextPowerOf2(traders_.size()));
+
+  for (size_t w = 0; w < workers_.size(); ++w) {
+    threads_.emplace_back(&TraderManager::workerLoop, this, w);
+  }
+}
+
+void TraderManager::stop() {
+  running_.store(false);
+  for (auto t : traders_) t->stop();
+  for (auto& w : workers_) w->signal.notify();
+}
+
+void TraderManager::join() {
+  for (auto& th : threads_) if (th.joinable()) th.join();
+  threads_.clear();
+}
+
+uint64_t TraderManager::ticks() const {
+  uint64_t total = 0;
+  for (auto& w : workers_) total += w->ticks.load(std::memory_order_relaxed);
+  return total;
+}
+
+// Dispatcher side (matching thread): queue the trader on its worker at most once
+void TraderManager::wake(Trader* t) {
+  if (!(t->wakeEvents() & WakeOnFill)) return;
+  if (t->wakePending_.exchange(true, std::memory_order_acq_rel)) return;
+
+  TraderWorker& w = *workers_[t->worker_];
+  Trader* head = w.inbox.load(std::memory_order_relaxed);
+  do {
+    t->nextReady_ = head;
+  } while (!w.inbox.compare_exchange_weak(head, t, std::memory_order_release,
+                                          std::memory_order_relaxed));
+  w.signal.notify();
+}
+
+// Queue a tick task unless one is already in flight; a trader woken while
+// its task is queued or running gets exactly one more tick afterwards.
+void TraderManager::schedule(TraderWorker& w, Trader* t) {
+  uint8_t s = t->sched_.load(std::memory_order_acquire);
+  while (true) {
+    if (s & kQueued) {
+      if ((s & kRerun) ||
+          t->sched_.compare_exchange_weak(s, s | kRerun, std::memory_order_acq_rel))
+        return;
+    } else if (t->sched_.compare_exchange_weak(s, kQueued, std::memory_order_acq_rel)) {
+      w.tasks->push(t);
+      ++w.pushed;
+      return;
+    }
+  }
+}
+
+void TraderManager::runTask(TraderWorker& w, Trader* t, int64_t now) {
+  if (t->isRunning()) {
+    t->applyReports();
+    t->tick();
+    w.ticks.fetch_add(1, std::memory_order_relaxed);
+
+    int64_t period = timerNs(t);
+    if (period > 0 && t->isRunning()) {
+      int64_t deadline = now + period;
+      t->nextTimer_.store(deadline, std::memory_order_relaxed);
+      w.timers.push({deadline, t});
+    }
+  }
+
+  // Stopped traders simply never get queued again
+  uint8_t s = t->sched_.load(std::memory_order_acquire);
+  while (true) {
+    if (s & kRerun) {
+      if (t->sched_.compare_exchange_weak(s, kQueued, std::memory_order_acq_rel)) {
+        if (t->isRunning()) {
+          w.tasks->push(t);
+        } else {
+          t->sched_.store(0, std::memory_order_release);
+        }
+        return;
+      }
+    } else if (t->sched_.compare_exchange_weak(s, 0, std::memory_order_acq_rel)) {
+      return;
+    }
+  }
+}
+
+bool TraderManager::steal(size_t thief, Trader*& out) {
+  for (size_t k = 1; k < workers_.size(); ++k) {
+    if (workers_[(thief + k) % workers_.size()]->tasks->steal(out)) return true;
+  }
+  return false;
+}
+
+void TraderManager::workerLoop(size_t index) {
+  TraderWorker& w = *workers_[index];
+
+  int64_t now = nowNs();
+  for (Trader* t : w.members) {
+    // first tick straight away, as the polling loop did
+    if (timerNs(t) > 0) {
+      t->nextTimer_.store(now, std::memory_order_relaxed);
+      w.timers.push({now, t});
+    }
+  }
+  w.seenQuote = quoteSeq_.load(std::memory_order_acquire);
+  w.seenTrade = tradeSeq_.load(std::memory_order_acquire);
+
+  auto addSubs = [&](std::vector<Trader*>& subs) {
+    for (size_t i = 0; i < subs.size();) {
+      if (!subs[i]->isRunning()) {
+        subs[i] = subs.back();  // stopped traders leave the rotation
+        subs.pop_back();
+        continue;
+      }
+      schedule(w, subs[i++]);
+    }
+  };
+
+  while (running_.load(std::memory_order_acquire)) {
+    uint32_t seen = w.signal.prepare();
+    w.pushed = 0;
+
+    // 1. traders woken by fills
+    Trader* t = w.inbox.exchange(nullptr, std::memory_order_acquire);
+    while (t) {
+      Trader* next = t->nextReady_;
+      t->wakePending_.store(false, std::memory_order_release);
+      schedule(w, t);
+      t = next;
+    }
+
+    // 2. market data: coalesced, one tick per subscriber per change burst
+    uint64_t qs = quoteSeq_.load(std::memory_order_acquire);
+    if (qs != w.seenQuote) {
+      w.seenQuote = qs;
+      addSubs(w.quoteSubs);
+    }
+    uint64_t ts = tradeSeq_.load(std::memory_order_acquire);
+    if (ts != w.seenTrade) {
+      w.seenTrade = ts;
+      addSubs(w.tradeSubs);
+    }
+
+    // 3. timers
+    now = nowNs();
+    while (!w.timers.empty() && w.timers.top().deadline <= now) {
+      TraderWorker::Timer timer = w.timers.top();
+      w.timers.pop();
+      if (timer.deadline == timer.trader->nextTimer_.load(std::memory_order_relaxed))
+        schedule(w, timer.trader);
+    }
+
+    // More than one new task: get a sleeping peer to come and steal
+    if (w.pushed > 1) {
+      for (size_t k = 1; k < workers_.size(); ++k) {
+        TraderWorker& peer = *workers_[(index + k) % workers_.size()];
+        if (peer.sleeping.load(std::memory_order_acquire)) {
+          peer.signal.notify();
+          break;
+        }
+      }
+    }
+
+    // 4. run own tasks (LIFO, cache-hot), then help others
+    bool ran = false;
+    while (w.tasks->pop(t) && running_.load(std::memory_order_relaxed)) {
+      runTask(w, t, now);
+      ran = true;
+    }
+    if (!ran && steal(index, t)) {
+      runTask(w, t, nowNs());
+      ran = true;
+    }
+    if (ran) continue;
+
+    int64_t timeout = w.timers.empty() ? -1 : w.timers.top().deadline - now;
+    w.sleeping.store(true, std::memory_order_release);
+    w.signal.wait(seen, timeout);
+    w.sleeping.store(false, std::memory_order_release);
+  }
+}
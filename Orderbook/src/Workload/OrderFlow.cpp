@@ -0,0 +1,212 @@
+#include "Workload/OrderFlow.hpp"
+
+#include <cmath>
+#include <cstdint>
+#include <functional>
+#include <queue>
+#include <random>
+
+#include "utils.hpp"
+
+namespace {
+
+// Live order as the generator remembers it
+struct LiveOrder {
+  uint64_t expiry;  // event index its lifetime runs out
+  OrderId id;
+  uint32_t owner;
+  Side side;
+  Price price = 0;
+  Quantity qty = 0;
+  bool operator>(const LiveOrder& o) const { return expiry > o.expiry; }
+};
+
+class FlowBuilder {
+ public:
+  FlowBuilder(const FlowProfile& p, uint64_t seed)
+      : p_(p),
+        gen_(seed),
+        mid_(p.mid),
+        depth_(1.0 / (1.0 + std::max(0.0, p.depthMean - 1.0))),
+        lifetime_(1.0 / std::max(1.0, p.lifetimeMean)),
+        gap_(p.arrival == Arrival::Hawkes
+                 ? p.rate * (1.0 - p.hawkesAlpha / p.hawkesBeta)  // base intensity
+                 : p.rate) {}
+
+  OrderRequest next(uint64_t i, OrderId& nextId) {
+    if (unit_(gen_) < p_.midDriftP) {
+      if (gen_() & 1) ++mid_;
+      else if (mid_ > Price(p_.maxDepth + 1)) --mid_;
+    }
+
+    double r = unit_(gen_);
+    if (live_.size() >= p_.maxLive) r = 0;  // full: cancel instead of adding
+    if (!live_.empty() && r < p_.cancelP + p_.modifyP) {
+      LiveOrder o = live_.top();
+      live_.pop();
+      if (r < p_.cancelP) {
+        return {RequestType::Cancel,
+                Order(o.id, o.owner, OrderType::GoodTillCancel, 0, 0, o.side)};
+      }
+      // a modified order gets a new lifetime, as if it were new
+      o.expiry = i + drawLifetime();
+      OrderRequest modify;
+      if (p_.amendDownP > 0 && unit_(gen_) < p_.amendDownP) {
+        // same price, smaller size (from the generator's view: fills may
+        // have taken the order below it already)
+        modify = {RequestType::Modify,
+                  Order(o.id, o.owner, OrderType::GoodTillCancel, o.price, 1 + gen_() % o.qty, o.side)};
+      } else {
+        modify = {RequestType::Modify,
+                  Order(o.id, o.owner, OrderType::GoodTillCancel, drawPrice(o.side), drawQty(), o.side)};
+      }
+      remember(o, modify);
+      return modify;
+    }
+
+    LiveOrder o{i + drawLifetime(), nextId++, uint32_t(1 + gen_() % p_.owners),
+                (gen_() & 1) ? Side::Buy : Side::Sell};
+    OrderRequest add{RequestType::Add,
+                     Order(o.id, o.owner, OrderType::GoodTillCancel, drawPrice(o.side), drawQty(), o.side)};
+    if (marketable_ && p_.marketableType != OrderType::GoodTillCancel) {
+      add.orderType = p_.marketableType;
+    } else {
+      remember(o, add);
+    }
+    return add;
+  }
+
+  // Ogata thinning for the exponential-kernel Hawkes process; plain
+  // exponential gaps for Poisson
+  double nextGap() {
+    if (p_.arrival == Arrival::Poisson) return std::exponential_distribution<double>(gap_)(gen_);
+
+    double waited = 0;
+    while (true) {
+      double bound = gap_ + excite_;
+      double w = std::exponential_distribution<double>(bound)(gen_);
+      waited += w;
+      excite_ *= std::exp(-p_.hawkesBeta * w);
+      if (unit_(gen_) * bound <= gap_ + excite_) {
+        excite_ += p_.hawkesAlpha;
+        return waited;
+      }
+    }
+  }
+
+ private:
+  void remember(LiveOrder o, const OrderRequest& sent) {
+    o.price = sent.price;
+    o.qty = sent.quantity;
+    live_.push(o);
+  }
+
+  Price drawPrice(Side side) {
+    marketable_ = unit_(gen_) < p_.marketableP;
+    if (marketable_) {
+      Price cross = gen_() % Price(p_.crossLevels + 1);
+      if (side == Side::Buy) return mid_ + cross;
+      return mid_ > cross ? mid_ - cross : 1;
+    }
+    Price behind = 1 + std::min<Price>(Price(p_.maxDepth - 1), depth_(gen_));
+    return side == Side::Buy ? mid_ - behind : mid_ + behind;
+  }
+
+  Quantity drawQty() { return p_.qtyMin + gen_() % (p_.qtyMax - p_.qtyMin + 1); }
+
+  uint64_t drawLifetime() { return 1 + uint64_t(lifetime_(gen_)); }
+
+  const FlowProfile& p_;
+  SplitMix64 gen_;
+  Price mid_;
+  bool marketable_ = false;  // whether the last drawPrice() crossed the mid
+  std::uniform_real_distribution<double> unit_{0.0, 1.0};
+  std::geometric_distribution<Price> depth_;
+  std::exponential_distribution<double> lifetime_;
+  double gap_;         // Poisson rate, or Hawkes base intensity
+  double excite_ = 0;  // Hawkes self-excitation at the last arrival
+  std::priority_queue<LiveOrder, std::vector<LiveOrder>, std::greater<LiveOrder>> live_;
+};
+
+}  // namespace
+
+std::vector<FlowEvent> generateFlow(const FlowProfile& profile, size_t events,
+                                    uint64_t seed, OrderId firstId) {
+  std::vector<FlowEvent> flow;
+  flow.reserve(events);
+
+  FlowBuilder builder(profile, seed);
+  OrderId nextId = firstId;
+  double t = 0;
+  for (size_t i = 0; i < events; ++i) {
+    t += builder.nextGap();
+    flow.push_back({int64_t(t * 1e9), builder.next(i, nextId)});
+  }
+  return flow;
+}
+
+const std::vector<FlowProfile>& flowProfiles() {
+  static const std::vector<FlowProfile> profiles = [] {
+    std::vector<FlowProfile> v;
+
+    // The old benchmark flow: GTC adds at one price, nothing else
+    FlowProfile single{"single-level"};
+    single.cancelP = 0;
+    single.modifyP = 0;
+    single.midDriftP = 0;
+    single.mid = 100;
+    single.marketableP = 1;
+    single.crossLevels = 0;
+    single.maxLive = SIZE_MAX;
+    v.push_back(single);
+
+    // Typical lit-book mix around a slowly moving mid
+    v.push_back(FlowProfile{"balanced"});
+
+    // Long-lived resting interest spread over hundreds of levels
+    FlowProfile deep{"deep-book"};
+    deep.cancelP = 0.15;
+    deep.modifyP = 0.02;
+    deep.maxLive = 200000;
+    deep.depthMean = 60;
+    deep.maxDepth = 500;
+    deep.marketableP = 0.05;
+    deep.lifetimeMean = 100000;
+    v.push_back(deep);
+
+    // Market-maker churn: mostly cancels at the touch, arriving in bursts
+    FlowProfile churn{"hft-churn"};
+    churn.cancelP = 0.5;
+    churn.modifyP = 0.1;
+    churn.maxLive = 2000;
+    churn.depthMean = 2;
+    churn.maxDepth = 20;
+    churn.marketableP = 0.05;
+    churn.lifetimeMean = 50;
+    churn.arrival = Arrival::Hawkes;
+    churn.hawkesAlpha = 8e5;
+    churn.hawkesBeta = 1e6;
+    v.push_back(churn);
+
+    // Large aggressive orders walking many levels of a deep book
+    FlowProfile sweep{"sweep-heavy"};
+    sweep.cancelP = 0.2;
+    sweep.modifyP = 0.05;
+    sweep.maxLive = 50000;
+    sweep.depthMean = 20;
+    sweep.maxDepth = 200;
+    sweep.marketableP = 0.3;
+    sweep.crossLevels = 50;
+    sweep.qtyMax = 1000;
+    v.push_back(sweep);
+
+    return v;
+  }();
+  return profiles;
+}
+
+const FlowProfile* findFlowProfile(std::string_view name) {
+  for (const FlowProfile& p : flowProfiles())
+    if (name == p.name) return &p;
+  return nullptr;
+}
@@ -1,13 +1,44 @@
 #include <gtest/gtest.h>
+#include <algorithm>
 #include <chrono>
+#include <cstdlib>
 #include <iostream>
 #include <thread>
 #include <vector>
+#include <deque>
 #include <random>
+#include <set>
 #include <memory>
 
+#include <sys/resource.h>
+
 #include "Orderbook/Order.hpp"
 #include "Orderbook/Orderbook.hpp"
+#include "Orderbook/HugePageArray.hpp"
+#include "Orderbook/LatencyStats.hpp"
+#include "Orderbook/OrderPool.hpp"
+#include "Orderbook/PriceBitmap.hpp"
+#include "Orderbook/PriceLadder.hpp"
+#include "Workload/OrderFlow.hpp"
+#include "utils.hpp"
+
+// Counts this thread's heap allocations while countAllocs is set, to check
+// that the engine's hot path stays off the general-purpose allocator.
+namespace
+{
+thread_local bool countAllocs = false;
+thread_local size_t allocCount = 0;
+}
+
+void* operator new(size_t bytes)
+{
+    if (countAllocs) ++allocCount;
+    if (void* p = std::malloc(bytes == 0 ? 1 : bytes)) return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, size_t) noexcept { std::free(p); }
 
 class OrderBookTest : public ::testing::Test
 {
@@ -272,14 +303,764 @@ TEST_F(OrderBookTest, ModifyOrder_ChangeSide)
     EXPECT_EQ(ob_->size(), 1);
 }
 
+TEST(OrderBookEngineTest, ArenasFirstTouchedByMatchingThread)
+{
+    auto minorFaults = []() {
+        rusage ru;
+        getrusage(RUSAGE_THREAD, &ru);
+        return ru.ru_minflt;
+    };
+
+    // ~200 MB of pool and ring: ~100 huge pages (or ~50k small ones) if
+    // this thread had touched them
+    const long before = minorFaults();
+    {
+        Orderbook ob(1 << 20, 0);
+        EXPECT_GT(ob.matchingThreadId(), 0);
+
+        const long faults = minorFaults() - before;
+        EXPECT_LT(faults, 32);
+    }
+
+    Orderbook inlineBook(1024, -1, EngineMode::Inline);
+    EXPECT_EQ(inlineBook.matchingThreadId(), 0);
+}
+
+TEST(OrderBookInlineTest, InlineMode_MatchesOnSubmittingThread)
+{
+    Orderbook ob(1024, -1, EngineMode::Inline);
+
+    Order sell(1, 2, OrderType::GoodTillCancel, 100, 10, Side::Sell);
+    OrderRequest addSell{RequestType::Add, sell};
+    ob.submitRequest(addSell);
+
+    // No worker thread: the book is updated before submitRequest returns
+    EXPECT_EQ(ob.size(), 1);
+    EXPECT_EQ(ob.topAskPrice(), 100);
+
+    Order buy(2, 1, OrderType::GoodTillCancel, 100, 4, Side::Buy);
+    OrderRequest addBuy{RequestType::Add, buy};
+    ob.submitRequest(addBuy);
+
+    EXPECT_EQ(ob.matchedTrades(), 1);
+    EXPECT_EQ(ob.matchedVolume(), 4);
+    EXPECT_EQ(ob.size(), 1);
+}
+
+TEST(OrderBookInlineTest, Acks_ReportOrderLifecycle)
+{
+    Orderbook ob(1024, -1, EngineMode::Inline);
+    std::vector<Ack> acks;
+    ob.setAckListener([&acks](Ack &a) { acks.push_back(a); });
+
+    auto submit = [&ob](RequestType type, Order o) {
+        OrderRequest req{type, o};
+        ob.submitRequest(req);
+    };
+
+    // Resting order is accepted
+    submit(RequestType::Add, Order(1, 1, OrderType::GoodTillCancel, 100, 10, Side::Sell));
+    // Fully filled on arrival: fills only, no ack
+    submit(RequestType::Add, Order(2, 2, OrderType::GoodTillCancel, 100, 4, Side::Buy));
+    // FAK remainder is dropped and reported as cancelled
+    submit(RequestType::Add, Order(3, 2, OrderType::FillAndKill, 100, 10, Side::Buy));
+    // Modify replaces silently and the replacement is accepted
+    submit(RequestType::Add, Order(4, 1, OrderType::GoodTillCancel, 90, 5, Side::Buy));
+    submit(RequestType::Modify, Order(4, 1, OrderType::GoodTillCancel, 91, 5, Side::Buy));
+    // Cancel of a live order, then of one that is gone
+    submit(RequestType::Cancel, Order(4, 1, OrderType::GoodTillCancel, 0, 0, Side::Buy));
+    submit(RequestType::Cancel, Order(4, 1, OrderType::GoodTillCancel, 0, 0, Side::Buy));
+
+    std::vector<std::pair<OrderId, AckType>> got;
+    for (auto &a : acks) got.push_back({a.orderId, a.type});
+
+    std::vector<std::pair<OrderId, AckType>> want = {
+        {1, AckType::Accepted},
+        {3, AckType::Cancelled},
+        {4, AckType::Accepted},
+        {4, AckType::Accepted},
+        {4, AckType::Cancelled},
+        {4, AckType::Rejected},
+    };
+    EXPECT_EQ(got, want);
+}
+
+TEST(OrderBookInlineTest, FillOrKill_AllOrNothing)
+{
+    Orderbook ob(1024, -1, EngineMode::Inline);
+    std::vector<Ack> acks;
+    std::vector<Quantity> fills;
+    ob.setAckListener([&acks](Ack &a) { acks.push_back(a); });
+    ob.setTradeListener([&fills](Trade &t) { fills.push_back(t.qty); });
+
+    auto add = [&ob](OrderId id, OrderType type, Price price, Quantity qty, Side side)
+    {
+        OrderRequest req{RequestType::Add, Order(id, 1, type, price, qty, side)};
+        ob.submitRequest(req);
+    };
+    add(1, OrderType::GoodTillCancel, 100, 5, Side::Sell);
+    add(2, OrderType::GoodTillCancel, 101, 5, Side::Sell);
+    acks.clear();
+
+    // more than rests up to the limit: killed without touching the book
+    add(3, OrderType::FillOrKill, 101, 12, Side::Buy);
+    add(4, OrderType::FillOrKill, 100, 6, Side::Buy);
+    EXPECT_TRUE(fills.empty());
+    ASSERT_EQ(acks.size(), 2u);
+    EXPECT_EQ(acks[0].orderId, 3u);
+    EXPECT_EQ(acks[0].type, AckType::Cancelled);
+    EXPECT_EQ(acks[1].type, AckType::Cancelled);
+    EXPECT_EQ(ob.size(), 2);
+    EXPECT_EQ(ob.depthTo(Side::Sell, 101), 10u);
+
+    // enough liquidity: fills in full across levels, nothing rests
+    add(5, OrderType::FillOrKill, 101, 8, Side::Buy);
+    EXPECT_EQ(fills, (std::vector<Quantity>{5, 3}));
+    EXPECT_EQ(acks.size(), 2u);
+    EXPECT_EQ(ob.size(), 1);
+    EXPECT_EQ(ob.topBidPrice(), 0);
+    EXPECT_EQ(ob.topAskPrice(), 101);
+}
+
+TEST(OrderBookInlineTest, ModifyDown_KeepsQueuePriority)
+{
+    Orderbook ob(1024, -1, EngineMode::Inline);
+    std::vector<Ack> acks;
+    std::vector<std::pair<OrderId, Quantity>> fills;
+    ob.setAckListener([&acks](Ack &a) { acks.push_back(a); });
+    ob.setTradeListener([&fills](Trade &t) { fills.push_back({t.ask->getOrderId(), t.qty}); });
+
+    auto submit = [&ob](RequestType type, OrderId id, Price price, Quantity qty, Side side)
+    {
+        OrderRequest req{type, Order(id, 1, OrderType::GoodTillCancel, price, qty, side)};
+        ob.submitRequest(req);
+    };
+    submit(RequestType::Add, 1, 100, 10, Side::Sell);
+    submit(RequestType::Add, 2, 100, 10, Side::Sell);
+    submit(RequestType::Add, 3, 100, 5, Side::Sell);
+    acks.clear();
+
+    // 1 shrinks in place and stays first; 2 grows and goes to the back
+    submit(RequestType::Modify, 1, 100, 4, Side::Sell);
+    submit(RequestType::Modify, 2, 100, 15, Side::Sell);
+    ASSERT_EQ(acks.size(), 2u);
+    EXPECT_EQ(acks[0].type, AckType::Accepted);
+    EXPECT_EQ(acks[1].type, AckType::Accepted);
+    EXPECT_EQ(ob.size(), 3);
+    EXPECT_EQ(ob.depthTo(Side::Sell, 100), 24u);
+
+    submit(RequestType::Add, 4, 100, 12, Side::Buy);
+    std::vector<std::pair<OrderId, Quantity>> want{{1, 4}, {3, 5}, {2, 3}};
+    EXPECT_EQ(fills, want);
+    EXPECT_EQ(ob.depthTo(Side::Sell, 100), 12u);
+}
+
+TEST(OrderBookInlineTest, CancelAllForOwner_OneRequestOneBatch)
+{
+    Orderbook ob(1024, -1, EngineMode::Inline);
+    std::vector<OrderId> batch;
+    size_t batches = 0;
+    std::vector<Ack> acks;
+    ob.setCancelBatchListener([&](CancelBatch &b)
+    {
+        EXPECT_EQ(b.owner, 7u);
+        batch.assign(b.orderIds, b.orderIds + b.count);
+        ++batches;
+    });
+    ob.setAckListener([&acks](Ack &a) { acks.push_back(a); });
+
+    auto submit = [&ob](RequestType type, OrderId id, uint32_t owner, Price price, Quantity qty, Side side)
+    {
+        OrderRequest req{type, Order(id, owner, OrderType::GoodTillCancel, price, qty, side)};
+        ob.submitRequest(req);
+    };
+    // owner 7 on both sides and several levels, owner 8 among them
+    submit(RequestType::Add, 1, 7, 100, 10, Side::Sell);
+    submit(RequestType::Add, 2, 8, 103, 10, Side::Sell);
+    submit(RequestType::Add, 3, 7, 101, 10, Side::Sell);
+    submit(RequestType::Add, 4, 7, 95, 10, Side::Buy);
+    submit(RequestType::Add, 5, 7, 94, 10, Side::Buy);
+    submit(RequestType::Add, 6, 8, 94, 10, Side::Buy);
+    submit(RequestType::Add, 7, 7, 102, 10, Side::Sell);
+
+    // leave 7's list by a fill (1), a cancel (5) and a partial fill (3 rests on)
+    submit(RequestType::Add, 8, 9, 101, 15, Side::Buy);
+    submit(RequestType::Cancel, 5, 7, 0, 0, Side::Buy);
+    ASSERT_EQ(ob.size(), 5);
+    acks.clear();
+
+    OrderRequest all{RequestType::CancelAllForOwner, Order(0, 7, OrderType::GoodTillCancel, 0, 0, Side::Buy)};
+    ob.submitRequest(all);
+    EXPECT_EQ(batches, 1u);
+    std::sort(batch.begin(), batch.end());
+    EXPECT_EQ(batch, (std::vector<OrderId>{3, 4, 7}));
+    EXPECT_TRUE(acks.empty());
+
+    EXPECT_EQ(ob.size(), 2);
+    EXPECT_EQ(ob.topBidPrice(), 94);
+    EXPECT_EQ(ob.topAskPrice(), 103);
+    EXPECT_EQ(ob.depthTo(Side::Sell, 200), 10u);
+    EXPECT_EQ(ob.depthTo(Side::Buy, 0), 10u);
+
+    // nothing left: an empty batch
+    ob.submitRequest(all);
+    EXPECT_EQ(batches, 2u);
+    EXPECT_TRUE(batch.empty());
+
+    // without a batch listener, one ack per cancelled order
+    ob.setCancelBatchListener(nullptr);
+    OrderRequest rest{RequestType::CancelAllForOwner, Order(0, 8, OrderType::GoodTillCancel, 0, 0, Side::Buy)};
+    ob.submitRequest(rest);
+    ASSERT_EQ(acks.size(), 2u);
+    EXPECT_EQ(acks[0].type, AckType::Cancelled);
+    EXPECT_EQ(acks[1].type, AckType::Cancelled);
+    EXPECT_EQ(ob.size(), 0);
+}
+
+TEST(OrderBookInlineTest, Quote_ReplacesPairKeepingPriority)
+{
+    Orderbook ob(1024, -1, EngineMode::Inline);
+    std::vector<Ack> acks;
+    std::vector<std::pair<OrderId, Quantity>> fills;
+    ob.setAckListener([&acks](Ack &a) { acks.push_back(a); });
+    ob.setTradeListener([&fills](Trade &t) { fills.push_back({t.bid->getOrderId(), t.qty}); });
+
+    auto quote = [&ob](OrderId bidId, Price bid, Quantity bidQty, OrderId askId, Price ask, Quantity askQty)
+    {
+        OrderRequest req{RequestType::Quote, Order(bidId, 5, OrderType::GoodTillCancel, bid, bidQty, Side::Buy)};
+        req.ask = {askId, ask, askQty};
+        ob.submitRequest(req);
+    };
+    auto add = [&ob](OrderId id, uint32_t owner, Price price, Quantity qty, Side side)
+    {
+        OrderRequest req{RequestType::Add, Order(id, owner, OrderType::GoodTillCancel, price, qty, side)};
+        ob.submitRequest(req);
+    };
+
+    quote(1, 99, 10, 2, 101, 10);
+    add(3, 6, 99, 10, Side::Buy);
+    ASSERT_EQ(ob.size(), 3);
+    acks.clear();
+
+    // bid: same price, less size -> 1 stays ahead of 3 and 10 is never
+    // placed; ask: new price -> 2 is replaced by 11
+    quote(10, 99, 5, 11, 102, 10);
+    ASSERT_EQ(acks.size(), 4u);
+    EXPECT_EQ(acks[0].orderId, 2u);
+    EXPECT_EQ(acks[0].type, AckType::Cancelled);
+    EXPECT_EQ(acks[1].orderId, 1u);
+    EXPECT_EQ(acks[1].type, AckType::Accepted);
+    EXPECT_EQ(acks[2].orderId, 10u);
+    EXPECT_EQ(acks[2].type, AckType::Cancelled);
+    EXPECT_EQ(acks[3].orderId, 11u);
+    EXPECT_EQ(acks[3].type, AckType::Accepted);
+    EXPECT_EQ(ob.size(), 3);
+    EXPECT_EQ(ob.topAskPrice(), 102);
+    EXPECT_EQ(ob.depthTo(Side::Buy, 99), 15u);
+
+    add(20, 7, 99, 7, Side::Sell);
+    std::vector<std::pair<OrderId, Quantity>> want{{1, 5}, {3, 2}};
+    EXPECT_EQ(fills, want);
+
+    // the filled bid leg is gone; size 0 withdraws the ask
+    acks.clear();
+    quote(12, 98, 4, 13, 0, 0);
+    ASSERT_EQ(acks.size(), 2u);
+    EXPECT_EQ(acks[0].orderId, 11u);
+    EXPECT_EQ(acks[0].type, AckType::Cancelled);
+    EXPECT_EQ(acks[1].orderId, 12u);
+    EXPECT_EQ(acks[1].type, AckType::Accepted);
+    EXPECT_EQ(ob.size(), 2);
+    EXPECT_EQ(ob.depthTo(Side::Sell, 1000), 0u);
+    EXPECT_EQ(ob.depthTo(Side::Buy, 0), 12u);
+
+    // a crossed quote is refused and leaves the old one standing
+    acks.clear();
+    quote(14, 105, 1, 15, 104, 1);
+    ASSERT_EQ(acks.size(), 2u);
+    EXPECT_EQ(acks[0].type, AckType::Rejected);
+    EXPECT_EQ(acks[1].type, AckType::Rejected);
+    EXPECT_EQ(ob.size(), 2);
+
+    // a bigger bid at the same price loses its place to a fresh order
+    acks.clear();
+    quote(16, 98, 6, 17, 0, 0);
+    ASSERT_EQ(acks.size(), 2u);
+    EXPECT_EQ(acks[0].orderId, 12u);
+    EXPECT_EQ(acks[0].type, AckType::Cancelled);
+    EXPECT_EQ(ob.size(), 2);
+    OrderRequest cancelOld{RequestType::Cancel, Order(12, 5, OrderType::GoodTillCancel, 0, 0, Side::Buy)};
+    acks.clear();
+    ob.submitRequest(cancelOld);
+    ASSERT_EQ(acks.size(), 1u);
+    EXPECT_EQ(acks[0].type, AckType::Rejected);
+
+    // mass cancel clears the quote too; the next one starts afresh
+    OrderRequest all{RequestType::CancelAllForOwner, Order(0, 5, OrderType::GoodTillCancel, 0, 0, Side::Buy)};
+    ob.submitRequest(all);
+    EXPECT_EQ(ob.size(), 1);
+    quote(18, 97, 1, 19, 103, 1);
+    EXPECT_EQ(ob.size(), 3);
+    EXPECT_EQ(ob.topBidPrice(), 99);
+    EXPECT_EQ(ob.topAskPrice(), 103);
+}
+
+TEST(OrderBookInlineTest, PoolLimit_RejectsInsteadOfThrowing)
+{
+    Orderbook ob(2, -1, EngineMode::Inline);
+    std::vector<Ack> acks;
+    ob.setAckListener([&acks](Ack &a) { acks.push_back(a); });
+
+    for (OrderId id = 1; id <= 3; ++id)
+    {
+        OrderRequest req{RequestType::Add, Order(id, 1, OrderType::GoodTillCancel, 100 + id, 1, Side::Sell)};
+        ob.submitRequest(req);
+    }
+    ASSERT_EQ(acks.size(), 3u);
+    EXPECT_EQ(acks[2].orderId, 3u);
+    EXPECT_EQ(acks[2].type, AckType::Rejected);
+    EXPECT_EQ(ob.size(), 2);
+
+    // the engine keeps going: a cancel frees a block for the next order
+    OrderRequest cancel{RequestType::Cancel, Order(1, 1, OrderType::GoodTillCancel, 0, 0, Side::Sell)};
+    ob.submitRequest(cancel);
+    OrderRequest retry{RequestType::Add, Order(5, 1, OrderType::GoodTillCancel, 105, 1, Side::Sell)};
+    ob.submitRequest(retry);
+    EXPECT_EQ(acks.back().type, AckType::Accepted);
+    EXPECT_EQ(ob.size(), 2);
+}
+
+TEST(OrderBookInlineTest, DepthAndSweepQueries)
+{
+    Orderbook ob(1024, -1, EngineMode::Inline);
+    auto add = [&ob](OrderId id, Price price, Quantity qty, Side side)
+    {
+        OrderRequest req{RequestType::Add, Order(id, 1, OrderType::GoodTillCancel, price, qty, side)};
+        ob.submitRequest(req);
+    };
+    add(1, 100, 10, Side::Sell);
+    add(2, 101, 5, Side::Sell);
+    add(3, 103, 20, Side::Sell);
+    add(4, 98, 7, Side::Buy);
+
+    EXPECT_EQ(ob.depthTo(Side::Sell, 101), 15u);
+    EXPECT_EQ(ob.depthTo(Side::Sell, 99), 0u);
+    EXPECT_EQ(ob.depthTo(Side::Buy, 90), 7u);
+    EXPECT_EQ(ob.priceFor(Side::Sell, 15), Price(101));
+    EXPECT_EQ(ob.priceFor(Side::Sell, 16), Price(103));
+    EXPECT_DOUBLE_EQ(*ob.sweepVwap(Side::Sell, 20), (100.0 * 10 + 101.0 * 5 + 103.0 * 5) / 20);
+    EXPECT_EQ(ob.priceFor(Side::Sell, 36), std::nullopt);
+
+    // fills and cancels keep the index in step
+    add(5, 100, 4, Side::Buy);
+    OrderRequest cancel{RequestType::Cancel, Order(2, 1, OrderType::GoodTillCancel, 0, 0, Side::Sell)};
+    ob.submitRequest(cancel);
+    EXPECT_EQ(ob.depthTo(Side::Sell, 101), 6u);
+    EXPECT_EQ(ob.priceFor(Side::Sell, 7), Price(103));
+    EXPECT_DOUBLE_EQ(*ob.sweepVwap(Side::Sell, 26), (100.0 * 6 + 103.0 * 20) / 26);
+}
+
+TEST(OrderBookInlineTest, SteadyStateTradingDoesNotAllocate)
+{
+    Orderbook ob(1 << 16, -1, EngineMode::Inline);
+    std::vector<FlowEvent> flow = generateFlow(*findFlowProfile("balanced"), 200000);
+
+    // the first half takes the book to its high-water mark: level nodes,
+    // index slots and pool slabs are all in place after it
+    const size_t half = flow.size() / 2;
+    for (size_t i = 0; i < half; ++i)
+    {
+        OrderRequest req = flow[i].request;
+        ob.submitRequest(req);
+    }
+
+    allocCount = 0;
+    countAllocs = true;
+    for (size_t i = half; i < flow.size(); ++i)
+    {
+        OrderRequest req = flow[i].request;
+        ob.submitRequest(req);
+    }
+    countAllocs = false;
+
+    EXPECT_EQ(allocCount, 0u);
+    EXPECT_GT(ob.matchedTrades(), 0u);
+}
+
+TEST(OrderFlowTest, GenerationIsDeterministicAndFollowsMix)
+{
+    const FlowProfile *profile = findFlowProfile("balanced");
+    ASSERT_NE(profile, nullptr);
+    EXPECT_EQ(findFlowProfile("no-such-profile"), nullptr);
+
+    const size_t n = 200000;
+    auto a = generateFlow(*profile, n, 7, 1000);
+    auto b = generateFlow(*profile, n, 7, 1000);
+    ASSERT_EQ(a.size(), n);
+
+    size_t adds = 0, cancels = 0, modifies = 0;
+    Price lo = UINT64_MAX, hi = 0;
+    for (size_t i = 0; i < n; ++i)
+    {
+        const OrderRequest &o = a[i].request;
+        ASSERT_EQ(o.type, b[i].request.type);
+        ASSERT_EQ(o.orderId, b[i].request.orderId);
+        ASSERT_EQ(o.price, b[i].request.price);
+        if (i)
+        {
+            ASSERT_GE(a[i].atNs, a[i - 1].atNs);
+        }
+
+        switch (a[i].request.type)
+        {
+        case RequestType::Add:
+            EXPECT_EQ(o.orderId, 1000 + adds);  // dense ids
+            ++adds;
+            break;
+        case RequestType::Cancel: ++cancels; break;
+        default: ++modifies; break;
+        }
+        if (a[i].request.type != RequestType::Cancel)
+        {
+            lo = std::min(lo, o.price);
+            hi = std::max(hi, o.price);
+        }
+    }
+
+    // mix within a couple of percent of the profile, many levels touched
+    EXPECT_NEAR(double(cancels) / n, profile->cancelP, 0.02);
+    EXPECT_NEAR(double(modifies) / n, profile->modifyP, 0.02);
+    EXPECT_GT(hi - lo, (Price)20);
+
+    // mean arrival rate close to the configured one
+    double seconds = double(a.back().atNs) / 1e9;
+    EXPECT_NEAR(n / seconds, profile->rate, profile->rate * 0.05);
+}
+
+TEST(LatencyHistogramTest, PercentilesWithinBucketPrecision)
+{
+    LatencyHistogram h;
+    for (uint64_t v = 1; v <= 100000; ++v) h.record(v);
+
+    EXPECT_EQ(h.count(), 100000u);
+    EXPECT_EQ(h.max(), 100000u);
+    EXPECT_NEAR(h.mean(), 50000.5, 0.01);
+
+    // values below 32 are exact, larger ones within one sub-bucket (~3%)
+    EXPECT_EQ(LatencyHistogram::upperOf(LatencyHistogram::bucketOf(17)), 17u);
+    for (double q : {0.5, 0.9, 0.99, 0.999})
+    {
+        double exact = q * 100000;
+        EXPECT_GE(double(h.percentile(q)), exact);
+        EXPECT_LE(double(h.percentile(q)), exact * 1.035);
+    }
+
+    // every bucket's upper bound maps back to the same bucket
+    for (size_t b = 0; b < LatencyHistogram::kBuckets; ++b)
+        ASSERT_EQ(LatencyHistogram::bucketOf(LatencyHistogram::upperOf(b)), b);
+}
+
+TEST(HugePageArrayTest, ZeroFilledWithFallback)
+{
+    struct Item
+    {
+        uint64_t a;
+        uint64_t b;
+    };
+
+    // below one huge page: always plain pages
+    HugePageArray<Item> small(100);
+    EXPECT_EQ(small.backing(), HugePageArray<Item>::Backing::Normal);
+
+    // 8 MB: huge pages when the machine offers them, else 4 KB pages
+    const size_t n = (size_t(8) << 20) / sizeof(Item);
+    HugePageArray<Item> large(n);
+#ifndef OB_ENABLE_HUGE_PAGES
+    EXPECT_EQ(large.backing(), HugePageArray<Item>::Backing::Normal);
+#endif
+    ASSERT_EQ(large.size(), n);
+    large.prefault(4);
+    for (size_t i = 0; i < n; i += 4096)
+    {
+        EXPECT_EQ(large[i].a, 0u);
+        EXPECT_EQ(large[i].b, 0u);
+    }
+    large[n - 1].b = 42;
+    EXPECT_EQ(large[n - 1].b, 42u);
+}
+
+TEST(OrderPoolTest, CarvesLazilyAndReusesReleasedBlocks)
+{
+    OrderPool<Order> pool(3);
+
+    auto a = pool.acquire(1, 1, OrderType::GoodTillCancel, 100, 5, Side::Buy);
+    auto b = pool.acquire(2, 1, OrderType::GoodTillCancel, 101, 5, Side::Buy);
+    ASSERT_NE(a, nullptr);
+    ASSERT_NE(b, nullptr);
+    EXPECT_EQ(a->getOrderId(), 1u);
+
+    // a released block is handed out again before fresh ones
+    Order* freed = a;
+    pool.release(a);
+    auto c = pool.acquire(3, 1, OrderType::GoodTillCancel, 102, 5, Side::Sell);
+    EXPECT_EQ(c, freed);
+    EXPECT_EQ(c->getPrice(), 102);
+
+    auto d = pool.acquire(4, 1, OrderType::GoodTillCancel, 103, 5, Side::Sell);
+    ASSERT_NE(d, nullptr);
+    EXPECT_EQ(pool.acquire(5, 1, OrderType::GoodTillCancel, 104, 5, Side::Sell), nullptr);
+}
+
+TEST(OrderPoolTest, GrowsBySlabsUpToHardLimit)
+{
+    // 10 blocks in slabs of 4, the spare slabs prepared in the background
+    OrderPool<Order> pool(10, -1, true, 4);
+    EXPECT_EQ(pool.slabs(), 1u);
+
+    std::vector<Order*> held;
+    for (OrderId id = 1; id <= 10; ++id)
+    {
+        held.push_back(pool.acquire(id, 1, OrderType::GoodTillCancel, 100, 1, Side::Buy));
+        ASSERT_NE(held.back(), nullptr);
+    }
+    EXPECT_EQ(pool.slabs(), 3u);
+    EXPECT_EQ(pool.acquire(11, 1, OrderType::GoodTillCancel, 100, 1, Side::Buy), nullptr);
+
+    // growth never moved earlier orders
+    for (size_t i = 0; i < held.size(); ++i) EXPECT_EQ(held[i]->getOrderId(), OrderId(i + 1));
+
+    pool.release(held[3]);
+    EXPECT_NE(pool.acquire(12, 1, OrderType::GoodTillCancel, 100, 1, Side::Buy), nullptr);
+}
+
+TEST(PriceBitmapTest, NextAndPrevMatchOrderedSet)
+{
+    PriceBitmap bits;
+    std::set<size_t> ref;
+    std::mt19937_64 gen(3);
+
+    // clustered at word and block boundaries, plus the two ends
+    auto draw = [&gen]() -> size_t
+    {
+        switch (gen() % 4)
+        {
+        case 0: return gen() % PriceBitmap::kBits;
+        case 1: return (gen() % 64) * 4096 + gen() % 3;
+        case 2: return (gen() % 4096) * 64 + 63;
+        default: return gen() % 2 ? 0 : PriceBitmap::kBits - 1;
+        }
+    };
+
+    for (int step = 0; step < 20000; ++step)
+    {
+        size_t i = draw();
+        if (gen() % 3 == 0)
+        {
+            bits.reset(i);
+            ref.erase(i);
+        }
+        else
+        {
+            bits.set(i);
+            ref.insert(i);
+        }
+
+        size_t q = draw();
+        auto up = ref.lower_bound(q);
+        ASSERT_EQ(bits.next(q), up == ref.end() ? PriceBitmap::kNone : *up);
+        auto down = ref.upper_bound(q);
+        ASSERT_EQ(bits.prev(q), down == ref.begin() ? PriceBitmap::kNone : *std::prev(down));
+        ASSERT_EQ(bits.empty(), ref.empty());
+    }
+}
+
+TEST(PriceLadderTest, OrdersLevelsAcrossWindowAndOverflow)
+{
+    PriceLadder<Side::Sell> asks;
+    PriceLadder<Side::Buy> bids;
+    const Price far = 10000 + PriceLadder<Side::Sell>::kTicks;
+
+    // the window centres on the first price; `far` and 1 land in overflow
+    for (Price p : {Price(10000), far, Price(10005), Price(1), Price(10001)})
+    {
+        asks.level(p).volume = p;
+        bids.level(p).volume = p;
+    }
+    EXPECT_EQ(asks.levels(), 5u);
+    EXPECT_EQ(asks.best(), 1u);
+    EXPECT_EQ(bids.best(), far);
+
+    std::vector<Price> up, down;
+    asks.forEach([&up](Price p, const PriceLevel &level) { EXPECT_EQ(level.volume, p); up.push_back(p); });
+    bids.forEach([&down](Price p, const PriceLevel &) { down.push_back(p); });
+    EXPECT_EQ(up, (std::vector<Price>{1, 10000, 10001, 10005, far}));
+    EXPECT_EQ(down, (std::vector<Price>{far, 10005, 10001, 10000, 1}));
+
+    EXPECT_EQ(asks.next(10002), Price(10005));
+    EXPECT_EQ(bids.next(10002), Price(10001));
+    EXPECT_EQ(asks.next(far + 1), std::nullopt);
+
+    // emptying the side lets the window move to the next price it sees
+    for (Price p : up) asks.remove(p);
+    EXPECT_TRUE(asks.empty());
+    EXPECT_EQ(asks.find(10000), nullptr);
+    asks.level(5 * far);
+    EXPECT_EQ(asks.best(), 5 * far);
+    EXPECT_EQ(asks.next(0), 5 * far);
+}
+
+TEST(PriceLadderTest, DepthQueriesMatchLevelWalk)
+{
+    PriceLadder<Side::Buy> bids;
+    PriceLadder<Side::Sell> asks;
+    std::deque<Order> orders;
+    std::vector<Order *> resting;
+    std::mt19937_64 gen(11);
+
+    // levels around 10000, a few far enough out to land in overflow
+    auto drawPrice = [&gen]() -> Price
+    {
+        if (gen() % 10 == 0) return gen() % 2 ? 10 : 10000 + PriceBitmap::kBits;
+        return 9900 + gen() % 200;
+    };
+
+    // reference: walk the levels best first
+    auto expectMatchesWalk = [](const auto &ladder, Price limit, Quantity want)
+    {
+        Quantity depth = 0;
+        SweepCost walk;
+        const bool buy = std::is_same_v<std::decay_t<decltype(ladder)>, PriceLadder<Side::Buy>>;
+        ladder.forEach([&](Price p, const PriceLevel &level)
+        {
+            if (buy ? p >= limit : p <= limit) depth += level.volume;
+            Quantity q = std::min(level.volume, want - walk.quantity);
+            if (q == 0) return;
+            walk.quantity += q;
+            walk.notional += double(p) * double(q);
+            walk.worst = p;
+        });
+
+        EXPECT_EQ(ladder.depthTo(limit), depth);
+        SweepCost got = ladder.sweep(want);
+        EXPECT_EQ(got.quantity, walk.quantity);
+        EXPECT_EQ(got.worst, walk.worst);
+        EXPECT_DOUBLE_EQ(got.notional, walk.notional);
+    };
+
+    for (int step = 0; step < 3000; ++step)
+    {
+        const int action = int(gen() % 4);
+        if (action < 2 || resting.empty())
+        {
+            Side side = gen() % 2 ? Side::Buy : Side::Sell;
+            orders.emplace_back(orders.size() + 1, 1, OrderType::GoodTillCancel, drawPrice(), 1 + gen() % 50, side);
+            Order *o = &orders.back();
+            side == Side::Buy ? bids.push(o) : asks.push(o);
+            resting.push_back(o);
+        }
+        else
+        {
+            size_t i = gen() % resting.size();
+            Order *o = resting[i];
+            const bool buy = o->getSide() == Side::Buy;
+            if (action == 2)
+            {
+                // partial fill, resting on
+                Quantity q = o->getQuantity() / 2;
+                o->Fill(q);
+                buy ? bids.reduce(o->getPrice(), *bids.find(o->getPrice()), q)
+                    : asks.reduce(o->getPrice(), *asks.find(o->getPrice()), q);
+            }
+            else
+            {
+                buy ? bids.erase(o) : asks.erase(o);
+                resting[i] = resting.back();
+                resting.pop_back();
+            }
+        }
+
+        Price limit = drawPrice();
+        Quantity want = 1 + gen() % 2000;
+        expectMatchesWalk(bids, limit, want);
+        expectMatchesWalk(asks, limit, want);
+    }
+}
+
+TEST(OrderBookEngineTest, StartupIndependentOfCapacity)
+{
+    // 64M orders: gigabytes of pool and ring if they were initialised
+    auto t0 = std::chrono::steady_clock::now();
+    {
+        Orderbook ob(1 << 26);
+        Order sell(1, 2, OrderType::GoodTillCancel, 100, 10, Side::Sell);
+        OrderRequest add{RequestType::Add, sell};
+        ob.submitRequest(add);
+    }
+    auto elapsed = std::chrono::steady_clock::now() - t0;
+    EXPECT_LT(std::chrono::duration_cast<std::chrono::milliseconds>(elapsed).count(), 500);
+}
+
+#ifdef OB_ENABLE_LATENCY
+TEST(LatencyStatsTest, StagesRecordedPerRequestType)
+{
+    Orderbook ob(1024);
+    const int n = 200;
+    for (int i = 1; i <= n; ++i)
+    {
+        OrderRequest add{RequestType::Add, Order(i, 1, OrderType::GoodTillCancel, 100 + i, 1, Side::Buy)};
+        ob.submitRequest(add);
+    }
+    for (int i = 1; i <= n / 2; ++i)
+    {
+        OrderRequest cancel{RequestType::Cancel, Order(i, 1, OrderType::GoodTillCancel, 0, 0, Side::Buy)};
+        ob.submitRequest(cancel);
+    }
+
+    // read live from this thread while the matching thread records
+    const LatencyStats &stats = ob.latencyStats();
+    int retries = 0;
+    while (stats[RequestType::Cancel].total.count() < n / 2 && ++retries < 200)
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+
+    EXPECT_EQ(stats[RequestType::Add].total.count(), (uint64_t)n);
+    EXPECT_EQ(stats[RequestType::Add].queue.count(), (uint64_t)n);
+    EXPECT_EQ(stats[RequestType::Add].service.count(), (uint64_t)n);
+    EXPECT_EQ(stats[RequestType::Cancel].total.count(), (uint64_t)n / 2);
+    EXPECT_EQ(stats[RequestType::Modify].total.count(), 0u);
+    EXPECT_GE(stats[RequestType::Add].total.max(), stats[RequestType::Add].service.max());
+
+    std::cout << "add total p50/p99: " << stats[RequestType::Add].total.percentile(0.5) / tscPerNs()
+              << " / " << stats[RequestType::Add].total.percentile(0.99) / tscPerNs() << " ns\n";
+}
+#endif
+
 // ==========================================
 // 2. HIGH PERFORMANCE BENCHMARKS
 // ==========================================
 
+// Workload for the engine benchmarks: OB_BENCH_PROFILE (see flowProfiles()),
+// "balanced" by default
+static const FlowProfile &benchProfile()
+{
+    const char *name = std::getenv("OB_BENCH_PROFILE");
+    const FlowProfile *profile = findFlowProfile(name ? name : "balanced");
+    if (!profile)
+    {
+        std::cout << "Unknown OB_BENCH_PROFILE '" << name << "', using balanced\n";
+        profile = findFlowProfile("balanced");
+    }
+    return *profile;
+}
+
 TEST_F(OrderBookTest, Benchmark_OrderInsertion)
 {
-    const int numOrders = 10000000; // Reverted to 5M
-    std::cout << "Starting Insertion Benchmark (" << numOrders << " orders)...\n";
+    const int numOrders = 10000000; // 10M requests
+    const FlowProfile &profile = benchProfile();
+    std::cout << "Starting Insertion Benchmark (" << numOrders << " requests, profile "
+              << profile.name << ")...\n";
+
+    // generated up front: only submission and matching are timed
+    std::vector<FlowEvent> flow = generateFlow(profile, numOrders);
 
     auto start = std::chrono::high_resolution_clock::now();
 
@@ -287,13 +1068,9 @@ TEST_F(OrderBookTest, Benchmark_OrderInsertion)
         // Use a local Orderbook to measure full lifecycle (including thread drain)
         Orderbook benchOb(1 << 24); // 16 Million slots
 
-        for (int i = 0; i < numOrders; ++i)
+        for (FlowEvent &e : flow)
         {
-            // TraderID 1, OrderID i
-            // Order constructor is (orderId, owner, ...)
-            Order order(i, 1, OrderType::GoodTillCancel, 100, 10, Side::Buy);
-            OrderRequest req{RequestType::Add, order};
-            benchOb.submitRequest(req);
+            benchOb.submitRequest(e.request);
         }
 
         // Destructor called here: sends STOP, waits for thread to finish processing
@@ -302,47 +1079,51 @@ TEST_F(OrderBookTest, Benchmark_OrderInsertion)
     auto end = std::chrono::high_resolution_clock::now();
     std::chrono::duration<double> diff = end - start;
 
-    std::cout << "Inserted " << numOrders << " orders in " << diff.count() << " s\n";
+    std::cout << "Processed " << numOrders << " requests in " << diff.count() << " s\n";
     std::cout << "Throughput: " << (long long)(numOrders / diff.count()) << " ops/sec\n";
     std::cout << "Average Latency: " << (diff.count() / numOrders) * 1e6 << " us/order\n";
 }
 
 TEST_F(OrderBookTest, Benchmark_RealWorldScenario)
 {
+    // Smoke-sized so it runs with the rest of the suite; order_book_bench
+    // has the full-size scenarios
     const int numThreads = 10;
-    const int numOps = 50000000; // Ops per thread (Total 10M ops)
+    const int numOps = 10000; // Ops per thread (Total 100k ops)
 
-    std::cout << "Starting Multi-Threaded Benchmark (" << numThreads << " producers, " << numOps * numThreads << " total ops)...\n";
+    const FlowProfile &profile = benchProfile();
+    std::cout << "Starting Multi-Threaded Benchmark (" << numThreads << " producers, " << numOps * numThreads
+              << " total ops, profile " << profile.name << ")...\n";
+
+    // Each producer replays its own pre-generated window, shifting ids on
+    // every pass so they stay unique
+    const size_t window = 1 << 13;
+    std::vector<std::vector<FlowEvent>> flows;
+    for (int t = 0; t < numThreads; ++t)
+        flows.push_back(generateFlow(profile, window, 12345 + t, 1));
 
     auto start = std::chrono::high_resolution_clock::now();
 
     {
-        Orderbook benchOb(1 << 26);
+        Orderbook benchOb(1 << 16);
         std::vector<std::thread> producers;
         producers.reserve(numThreads);
 
         for (int t = 0; t < numThreads; ++t)
         {
             producers.emplace_back(
-                [&benchOb, t, numOps]()
+                [&benchOb, &flows, window, t, numOps]()
                 {
-                    // Random generators
-                    std::mt19937 gen(12345 + t);
-                    std::uniform_int_distribution<> qtyDist(1, 100);
-                    std::uniform_int_distribution<> sideDist(0, 1);
+                    const std::vector<FlowEvent> &flow = flows[t];
 
                     // Partition IDs to avoid collision
-                    OrderId nextOrderId = (OrderId)t * (OrderId)numOps * 2 + 1;
+                    const OrderId base = (OrderId)t * (OrderId)numOps * 2;
 
                     for (int i = 0; i < numOps; ++i)
                     {
-                        // Simple 50/50 buy/sell mix
-                        Side s = sideDist(gen) == 0 ? Side::Buy : Side::Sell;
-
-                        // TraderID = t
-                        // Order constructor is (orderId, owner, ...)
-                        Order order(nextOrderId++, t, OrderType::GoodTillCancel, 100, qtyDist(gen), s);
-                        OrderRequest req{RequestType::Add, order};
+                        OrderRequest req = flow[i & (window - 1)].request;
+                        req.orderId += base + (OrderId)(i / window) * window;
+                        req.owner = t; // TraderID = t
 
                         benchOb.submitRequest(req);
                     }
@@ -1,11 +1,22 @@
 #include <gtest/gtest.h>
+#include <algorithm>
 #include <chrono>
+#include <iostream>
 #include <thread>
 #include <memory>
 
 #include "Orderbook/Orderbook.hpp"
 #include "Trader/TraderManager.hpp"
 #include "Trader/Trader.hpp"
+#include "Trader/NoiseTrader.hpp"
+#include "Trader/WhaleTrader.hpp"
+#include "Trader/MomentumTrader.hpp"
+#include "Trader/TradeTape.hpp"
+#include "Sweep/Sweep.hpp"
+#include "Trader/CoScheduler.hpp"
+#include "Trader/OwnerRegistry.hpp"
+#include "Trader/OrderIdAllocator.hpp"
+#include "Scheduler/SpscQueue.hpp"
 
 class TraderSimulationTest : public ::testing::Test {
  protected:
@@ -216,8 +227,12 @@ TEST_F(TraderSimulationTest, Trader_CancelsOrder)
   mgr_->addTrader(canceller);
   mgr_->start();
 
-  // book should briefly have size 1 then return to 0 after cancel
+  // the trader stops itself once it has sent the cancel
   int retries = 0;
+  while (canceller->isRunning() && ++retries < 200) std::this_thread::sleep_for(std::chrono::milliseconds(5));
+
+  // book should briefly have size 1 then return to 0 after cancel
+  retries = 0;
   while (ob_->size() != 0 && ++retries < 200) std::this_thread::sleep_for(std::chrono::milliseconds(5));
 
   mgr_->stop();
@@ -226,6 +241,307 @@ TEST_F(TraderSimulationTest, Trader_CancelsOrder)
   EXPECT_EQ(ob_->size(), 0);
 }
 
+// Exposes the order helpers so a test can script the trader directly
+class ScriptedTrader : public Trader {
+ public:
+  ScriptedTrader(uint32_t id, Orderbook &ob) : Trader(id, 100000, Strategy::Noise, ob) {}
+  void tick() override {}
+
+  using Trader::placeOrder;
+  using Trader::cancelOrder;
+  using Trader::modifyOrder;
+  const TrackedOrder *tracked(OrderId id) { return orders_.find(id); }
+  uint64_t reservedStock() const { return reservedStock_.load(); }
+  uint64_t reservedCash() const { return reservedCash_.load(); }
+  uint64_t cash() const { return cash_.load(); }
+  uint64_t stock() const { return stock_.load(); }
+};
+
+TEST(TraderOrderStateTest, ExecutionReportsDriveOrderTable)
+{
+  Orderbook ob(1024, -1, EngineMode::Inline);
+  TraderManager mgr(ob);
+  auto maker = std::make_shared<ScriptedTrader>(1, ob);
+  auto taker = std::make_shared<ScriptedTrader>(2, ob);
+  mgr.addTrader(maker);
+  mgr.addTrader(taker);
+
+  OrderId ask = maker->placeOrder(OrderType::GoodTillCancel, 100, 10, Side::Sell);
+  OrderId rest = maker->placeOrder(OrderType::GoodTillCancel, 120, 5, Side::Sell);
+  ASSERT_EQ(maker->tracked(ask)->state, OrderState::Pending);
+  mgr.step();
+  EXPECT_EQ(maker->tracked(ask)->state, OrderState::Live);
+
+  taker->placeOrder(OrderType::GoodTillCancel, 100, 4, Side::Buy);
+  mgr.step();
+  EXPECT_EQ(maker->tracked(ask)->state, OrderState::PartiallyFilled);
+  EXPECT_EQ(maker->tracked(ask)->remaining(), (Quantity)6);
+  EXPECT_EQ(taker->workingOrders(), (size_t)0);  // filled on arrival
+
+  taker->placeOrder(OrderType::GoodTillCancel, 100, 6, Side::Buy);
+  mgr.step();
+  EXPECT_EQ(maker->tracked(ask), nullptr);
+  EXPECT_EQ(maker->workingOrders(), (size_t)1);
+
+  // Nothing is sent for an order that is no longer working
+  EXPECT_FALSE(maker->cancelOrder(ask));
+  EXPECT_TRUE(maker->cancelOrder(rest));
+  EXPECT_FALSE(maker->cancelOrder(rest));  // already in flight
+  mgr.step();
+  EXPECT_EQ(maker->workingOrders(), (size_t)0);
+  EXPECT_EQ(maker->reservedStock(), (uint64_t)0);
+  EXPECT_EQ(ob.size(), 0);
+}
+
+TEST(TraderOrderStateTest, ReservationsFollowOrders)
+{
+  Orderbook ob(2, -1, EngineMode::Inline);  // room for two orders
+  TraderManager mgr(ob);
+  auto maker = std::make_shared<ScriptedTrader>(1, ob);
+  auto buyer = std::make_shared<ScriptedTrader>(2, ob);
+  mgr.addTrader(maker);
+  mgr.addTrader(buyer);
+
+  // a buy that fills below its limit frees all it reserved
+  maker->placeOrder(OrderType::GoodTillCancel, 100, 10, Side::Sell);
+  buyer->placeOrder(OrderType::GoodTillCancel, 105, 4, Side::Buy);
+  mgr.step();
+  EXPECT_EQ(buyer->workingOrders(), (size_t)0);
+  EXPECT_EQ(buyer->reservedCash(), (uint64_t)0);
+
+  // the book is full: the second order is rejected and frees its cash
+  OrderId bid = buyer->placeOrder(OrderType::GoodTillCancel, 90, 10, Side::Buy);
+  buyer->placeOrder(OrderType::GoodTillCancel, 80, 1, Side::Buy);
+  EXPECT_EQ(buyer->reservedCash(), (uint64_t)980);
+  mgr.step();
+  EXPECT_EQ(buyer->workingOrders(), (size_t)1);
+  EXPECT_EQ(buyer->reservedCash(), (uint64_t)900);
+
+  // a modify swaps the old reservation for the new one once it is applied
+  EXPECT_TRUE(buyer->modifyOrder(bid, OrderType::GoodTillCancel, 85, 4, Side::Buy));
+  EXPECT_EQ(buyer->reservedCash(), (uint64_t)1240);
+  mgr.step();
+  EXPECT_EQ(buyer->reservedCash(), (uint64_t)340);
+  EXPECT_TRUE(buyer->cancelOrder(bid));
+  mgr.step();
+  EXPECT_EQ(buyer->workingOrders(), (size_t)0);
+  EXPECT_EQ(buyer->reservedCash(), (uint64_t)0);
+}
+
+TEST(TraderOrderStateTest, ModifySettlesQueuedAndStaleFills)
+{
+  // The trader's book has no manager listening, so the test plays the
+  // engine's reports by hand and can order them as a threaded engine may
+  Orderbook ob(16, -1, EngineMode::Inline);
+  Orderbook quiet(16, -1, EngineMode::Inline);
+  TraderManager mgr(ob);
+  auto trader = std::make_shared<ScriptedTrader>(1, quiet);
+  ScriptedTrader &buyer = *trader;
+  mgr.addTrader(trader);
+
+  OrderId bid = buyer.placeOrder(OrderType::GoodTillCancel, 90, 10, Side::Buy);
+  Ack accepted{bid, 1, AckType::Accepted};
+  buyer.onAck(accepted);
+  buyer.applyReports();
+  ASSERT_EQ(buyer.reservedCash(), (uint64_t)900);
+
+  Order oldBid(bid, 1, OrderType::GoodTillCancel, 90, 10, Side::Buy);
+  Order seller(1000, 2, OrderType::GoodTillCancel, 90, 10, Side::Sell);
+  Trade queued{&oldBid, &seller, 3, 90};
+  buyer.onTrade(queued);  // not applied yet
+  EXPECT_EQ(buyer.stock(), (uint64_t)3);
+  EXPECT_EQ(buyer.cash(), (uint64_t)(100000 - 270));
+
+  // the queued fill is settled first; the unfilled 7 stay reserved until
+  // the engine answers the modify
+  EXPECT_TRUE(buyer.modifyOrder(bid, OrderType::GoodTillCancel, 85, 4, Side::Buy));
+  EXPECT_EQ(buyer.reservedCash(), (uint64_t)(630 + 340));
+  EXPECT_EQ(buyer.tracked(bid)->remaining(), (Quantity)4);
+  EXPECT_FALSE(buyer.modifyOrder(bid, OrderType::GoodTillCancel, 80, 4, Side::Buy));
+
+  // the old incarnation fills again before the engine reaches the modify
+  Trade stale{&oldBid, &seller, 2, 90};
+  buyer.onTrade(stale);
+  buyer.onAck(accepted);
+  buyer.applyReports();
+  ASSERT_NE(buyer.tracked(bid), nullptr);
+  EXPECT_EQ(buyer.tracked(bid)->state, OrderState::Live);
+  EXPECT_EQ(buyer.tracked(bid)->remaining(), (Quantity)4);
+  EXPECT_EQ(buyer.reservedCash(), (uint64_t)340);
+
+  Order newBid(bid, 1, OrderType::GoodTillCancel, 85, 4, Side::Buy);
+  Trade fill{&newBid, &seller, 4, 85};
+  buyer.onTrade(fill);
+  buyer.applyReports();
+  EXPECT_EQ(buyer.tracked(bid), nullptr);
+  EXPECT_EQ(buyer.reservedCash(), (uint64_t)0);
+  EXPECT_EQ(buyer.stock(), (uint64_t)9);
+  EXPECT_EQ(buyer.cash(), (uint64_t)(100000 - 270 - 180 - 340));
+}
+
+TEST(WhaleTraderTest, SweepsManyLevelsThenRefillsIceberg)
+{
+  Orderbook ob(1024, -1, EngineMode::Inline);
+  TraderManager mgr(ob);
+  auto maker = std::make_shared<ScriptedTrader>(1, ob);
+  WhaleTraderParams params{/*sweepEvery=*/100, /*sweepLevels=*/30, /*sweepQty=*/100000,
+                           /*icebergQty=*/5, /*icebergRefills=*/2};
+  auto whale = std::make_shared<WhaleTrader>(100, 1000000, ob, params);  // sweeps on its first tick
+  mgr.addTrader(maker);
+  mgr.addTrader(whale);
+
+  for (Price p = 101; p <= 200; ++p) maker->placeOrder(OrderType::GoodTillCancel, p, 10, Side::Sell);
+  for (Price p = 90; p <= 99; ++p) maker->placeOrder(OrderType::GoodTillCancel, p, 10, Side::Buy);
+
+  // FAK buy limited at 101 + 30 walks and erases 31 ask levels, rests nothing
+  mgr.step();
+  EXPECT_EQ(whale->sweeps(), 1u);
+  EXPECT_EQ(ob.matchedTrades(), 31u);
+  EXPECT_EQ(ob.topAskPrice(), 132);
+
+  // the FAK's reports retire it; the first iceberg slice joins the bid touch
+  mgr.step();
+  EXPECT_EQ(whale->workingOrders(), (size_t)1);
+  EXPECT_EQ(ob.size(), (size_t)80);
+
+  // still resting: no refill yet
+  mgr.step();
+  EXPECT_EQ(whale->workingOrders(), (size_t)1);
+
+  // filling the whole 99 level takes the slice; the next one goes to 98
+  maker->placeOrder(OrderType::FillAndKill, 99, 15, Side::Sell);
+  mgr.step();
+  EXPECT_EQ(whale->workingOrders(), (size_t)1);
+  EXPECT_EQ(ob.topBidPrice(), 98);
+
+  // refills exhausted after the second slice fills
+  maker->placeOrder(OrderType::FillAndKill, 98, 15, Side::Sell);
+  mgr.step();
+  mgr.step();
+  EXPECT_EQ(whale->workingOrders(), (size_t)0);
+}
+
+TEST(WhaleTraderTest, SweepEveryBelowOneSweepsEveryTick)
+{
+  Orderbook ob(1024, -1, EngineMode::Inline);
+  TraderManager mgr(ob);
+  auto maker = std::make_shared<ScriptedTrader>(1, ob);
+  WhaleTraderParams zero{/*sweepEvery=*/0, /*sweepLevels=*/1, /*sweepQty=*/1,
+                         /*icebergQty=*/1, /*icebergRefills=*/0};
+  WhaleTraderParams negative = zero;
+  negative.sweepEvery = -5;
+  auto a = std::make_shared<WhaleTrader>(100, 1000000, ob, zero);
+  auto b = std::make_shared<WhaleTrader>(101, 1000000, ob, negative);
+  mgr.addTrader(maker);
+  mgr.addTrader(a);
+  mgr.addTrader(b);
+
+  for (Price p = 101; p <= 110; ++p) maker->placeOrder(OrderType::GoodTillCancel, p, 10, Side::Sell);
+  for (Price p = 90; p <= 99; ++p) maker->placeOrder(OrderType::GoodTillCancel, p, 10, Side::Buy);
+
+  for (int i = 0; i < 3; ++i) mgr.step();
+  EXPECT_EQ(a->sweeps(), 3u);
+  EXPECT_EQ(b->sweeps(), 3u);
+}
+
+TEST(TradeTapeTest, SlowReaderSkipsOverwrittenPrints)
+{
+  TradeTape tape(8);
+  uint64_t fast = 0, slow = 0;
+  std::vector<Price> seen;
+
+  for (Price p = 1; p <= 5; ++p) tape.append(p, 1);
+  EXPECT_EQ(tape.read(fast, [](const Print&) {}), 5u);
+
+  for (Price p = 6; p <= 12; ++p) tape.append(p, 1);
+  EXPECT_EQ(tape.read(fast, [](const Print&) {}), 7u);
+  for (Price p = 13; p <= 20; ++p) tape.append(p, 1);
+  EXPECT_EQ(tape.read(fast, [](const Print&) {}), 8u);
+
+  // only the last 8 prints survive for a reader that never kept up
+  EXPECT_EQ(tape.read(slow, [&seen](const Print& pr) { seen.push_back(pr.price); }), 8u);
+  EXPECT_EQ(seen.front(), 13u);
+  EXPECT_EQ(seen.back(), 20u);
+  EXPECT_EQ(slow, tape.head());
+}
+
+TEST(MomentumTraderTest, FiresOnEmaCross)
+{
+  Orderbook ob(1024, -1, EngineMode::Inline);
+  TraderManager mgr(ob);
+  auto maker = std::make_shared<ScriptedTrader>(1, ob);
+  auto taker = std::make_shared<ScriptedTrader>(2, ob);
+  auto momo = std::make_shared<MomentumTrader>(3, 1000000, ob,
+                                               MomentumTraderParams{/*shortWindow=*/2, /*longWindow=*/4,
+                                                                    /*qty=*/5, /*aggression=*/3});
+  mgr.addTrader(maker);
+  mgr.addTrader(taker);
+  mgr.addTrader(momo);
+
+  maker->placeOrder(OrderType::GoodTillCancel, 130, 10, Side::Sell);
+  auto print = [&](Price p) {
+    maker->placeOrder(OrderType::GoodTillCancel, p, 1, Side::Sell);
+    taker->placeOrder(OrderType::FillAndKill, p, 1, Side::Buy);
+  };
+
+  for (int i = 0; i < 4; ++i) print(100);
+  mgr.step();
+  EXPECT_DOUBLE_EQ(momo->shortEma(), 100.0);
+  EXPECT_DOUBLE_EQ(momo->longEma(), 100.0);
+
+  // falling prints establish a down trend: baseline only, nothing sent
+  print(90);
+  print(85);
+  mgr.step();
+  EXPECT_LT(momo->shortEma(), momo->longEma());
+  EXPECT_EQ(momo->signals(), 0u);
+
+  // the fast EMA crosses back above: buy through the ask at 130
+  uint64_t trades = ob.matchedTrades();
+  print(110);
+  print(120);
+  mgr.step();
+  EXPECT_GT(momo->shortEma(), momo->longEma());
+  EXPECT_EQ(momo->signals(), 1u);
+  EXPECT_EQ(ob.matchedTrades(), trades + 3);  // two prints and the momentum fill
+
+  // its own print does not reverse the trend
+  mgr.step();
+  EXPECT_EQ(momo->signals(), 1u);
+}
+
+TEST(MomentumTraderTest, SellAggressorsPrintAtTheRestingBid)
+{
+  Orderbook ob(1024, -1, EngineMode::Inline);
+  TraderManager mgr(ob);
+  auto maker = std::make_shared<ScriptedTrader>(1, ob);
+  auto taker = std::make_shared<ScriptedTrader>(2, ob);
+  auto momo = std::make_shared<MomentumTrader>(3, 1000000, ob,
+                                               MomentumTraderParams{/*shortWindow=*/2, /*longWindow=*/4,
+                                                                    /*qty=*/5, /*aggression=*/3});
+  mgr.addTrader(maker);
+  mgr.addTrader(taker);
+  mgr.addTrader(momo);
+
+  // market sells limited at 1 trade at each resting bid, not at 1
+  auto print = [&](Price p) {
+    maker->placeOrder(OrderType::GoodTillCancel, p, 1, Side::Buy);
+    taker->placeOrder(OrderType::FillAndKill, 1, 1, Side::Sell);
+  };
+
+  for (int i = 0; i < 4; ++i) print(100);
+  mgr.step();
+  EXPECT_DOUBLE_EQ(momo->shortEma(), 100.0);
+  EXPECT_DOUBLE_EQ(momo->longEma(), 100.0);
+
+  print(102);
+  print(101);
+  mgr.step();
+  EXPECT_GT(momo->shortEma(), 100.0);
+  EXPECT_GT(momo->shortEma(), momo->longEma());
+  EXPECT_EQ(momo->signals(), 0u);
+}
+
 // Trader that places then modifies its own order on second tick
 class ModifyingTrader : public Trader {
  public:
@@ -319,6 +635,27 @@ TEST_F(TraderSimulationTest, Workers_InvokeAllTicks)
   for (auto* t : raw) EXPECT_GE(t->ticks(), 1);
 }
 
+TEST_F(TraderSimulationTest, StoppedTraders_LeaveRotation)
+{
+  const int N = 16;
+  std::vector<CountingTrader*> raw;
+
+  for (int i = 0; i < N; ++i) {
+    auto up = std::make_shared<CountingTrader>(70 + i, 100000, *ob_);
+    raw.push_back(up.get());
+    mgr_->addTrader(up);
+  }
+
+  mgr_->start();
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  mgr_->stop();
+  mgr_->join();
+
+  // each trader stopped itself in its first tick and was never ticked again
+  for (auto* t : raw) EXPECT_EQ(t->ticks(), 1);
+  EXPECT_EQ(mgr_->ticks(), (uint64_t)N);
+}
+
 // Small multi-tick stress: each trader emits several orders over successive ticks
 class BurstTrader : public Trader {
  public:
@@ -354,3 +691,606 @@ TEST_F(TraderSimulationTest, ShortBurst_ManyTraders)
 
   EXPECT_GE(ob_->size(), (size_t)(N * bursts / 2)); // at least half should remain (non-flaky check)
 }
+
+
+// Burns a fixed amount of CPU per tick, like a heavy strategy would
+class SpinTrader : public Trader {
+ public:
+  SpinTrader(uint32_t id, Orderbook &ob, std::chrono::microseconds cost)
+      : Trader(id, 100000, Strategy::Noise, ob), cost_(cost) {}
+  void tick() override {
+    auto end = std::chrono::steady_clock::now() + cost_;
+    while (std::chrono::steady_clock::now() < end) {}
+    ticks_.fetch_add(1, std::memory_order_relaxed);
+  }
+  int ticks() const { return ticks_.load(); }
+ private:
+  std::chrono::microseconds cost_;
+  std::atomic<int> ticks_{0};
+};
+
+TEST_F(TraderSimulationTest, Benchmark_HeterogeneousTickThroughput)
+{
+  const int light = 256;
+  const int heavy = 4;
+  std::vector<SpinTrader*> raw;
+
+  for (int i = 0; i < light + heavy; ++i) {
+    auto cost = std::chrono::microseconds(i < light ? 1 : 500);
+    auto t = std::make_shared<SpinTrader>(200 + i, *ob_, cost);
+    raw.push_back(t.get());
+    mgr_->addTrader(t);
+  }
+
+  auto start = std::chrono::steady_clock::now();
+  mgr_->start();
+  std::this_thread::sleep_for(std::chrono::milliseconds(500));
+  mgr_->stop();
+  mgr_->join();
+  std::chrono::duration<double> diff = std::chrono::steady_clock::now() - start;
+
+  std::cout << "Ticked " << mgr_->ticks() << " times (" << light << " light, " << heavy
+            << " heavy traders) in " << diff.count() << " s\n";
+  std::cout << "Throughput: " << (long long)(mgr_->ticks() / diff.count()) << " ticks/sec\n";
+
+  // heavy traders must not starve the light ones
+  for (auto* t : raw) EXPECT_GE(t->ticks(), 1);
+}
+
+// Per-tick latency of a NoiseTrader crowd, with and without whales sweeping
+// tens of levels through it. Inline book: a tick includes its matching.
+TEST(WhaleTraderTest, Benchmark_SweepTailLatency)
+{
+  const int noise = 256;
+  const int rounds = 2000;
+
+  auto pct = [](std::vector<int64_t>& v, double q) {
+    if (v.empty()) return int64_t(0);
+    size_t i = std::min(v.size() - 1, size_t(q * double(v.size())));
+    std::nth_element(v.begin(), v.begin() + i, v.end());
+    return v[i];
+  };
+
+  for (int whales : {0, 4}) {
+    Orderbook ob(nextPowerOf2(size_t(noise + whales) * Config::maxOrdersPerTrader), -1,
+                 EngineMode::Inline);
+    TraderManager mgr(ob);
+    std::vector<std::shared_ptr<Trader>> traders;
+    uint32_t id = 1;
+    for (int i = 0; i < noise; ++i)
+      traders.push_back(std::make_shared<NoiseTrader>(id++, UINT64_MAX, ob, NoiseTraderParams{}, 42));
+    for (int i = 0; i < whales; ++i)
+      traders.push_back(std::make_shared<WhaleTrader>(id++, UINT64_MAX, ob));
+    for (auto& t : traders) mgr.addTrader(t);
+
+    std::vector<int64_t> noiseNs, whaleNs;
+    noiseNs.reserve(size_t(noise) * rounds);
+    uint64_t sweepTrades = 0;
+
+    for (int r = 0; r < rounds; ++r) {
+      for (auto& t : traders) {
+        uint64_t trades = ob.matchedTrades();
+        int64_t start = nowNs();
+        t->applyReports();
+        t->tick();
+        int64_t ns = nowNs() - start;
+
+        if (t->getStrategy() == Strategy::Whale) {
+          whaleNs.push_back(ns);
+          sweepTrades += ob.matchedTrades() - trades;
+        } else {
+          noiseNs.push_back(ns);
+        }
+      }
+    }
+
+    std::cout << noise << " noise + " << whales << " whales, " << rounds << " rounds\n";
+    std::cout << "  noise tick ns p50/p99/p99.9/max: " << pct(noiseNs, 0.5) << " / "
+              << pct(noiseNs, 0.99) << " / " << pct(noiseNs, 0.999) << " / "
+              << pct(noiseNs, 1.0) << "\n";
+    if (whales) {
+      uint64_t sweeps = 0;
+      for (auto& t : traders)
+        if (auto* w = dynamic_cast<WhaleTrader*>(t.get())) sweeps += w->sweeps();
+      std::cout << "  whale tick ns p50/p99/max: " << pct(whaleNs, 0.5) << " / "
+                << pct(whaleNs, 0.99) << " / " << pct(whaleNs, 1.0) << "\n";
+      std::cout << "  sweeps: " << sweeps << ", trades printed by whale ticks: " << sweepTrades << "\n";
+      EXPECT_GT(sweeps, 0u);
+    }
+  }
+}
+
+// Noise flow with a crowd of trade-driven momentum agents on the threaded
+// book: every print wakes the whole crowd, and crosses arrive as bursts of
+// aggressive orders on the same side.
+TEST_F(TraderSimulationTest, Benchmark_MomentumFeedbackBursts)
+{
+  const int noise = 64;
+  const int momentum = 256;
+  std::vector<MomentumTrader*> crowd;
+
+  uint32_t id = 1;
+  for (int i = 0; i < noise; ++i)
+    mgr_->addTrader(std::make_shared<NoiseTrader>(id++, UINT64_MAX, *ob_));
+  for (int i = 0; i < momentum; ++i) {
+    // a spread of windows so the crowd is correlated but not identical
+    MomentumTraderParams params;
+    params.shortWindow = 4 + i % 8;
+    params.longWindow = 16 + i % 32;
+    auto t = std::make_shared<MomentumTrader>(id++, UINT64_MAX, *ob_, params);
+    crowd.push_back(t.get());
+    mgr_->addTrader(t);
+  }
+
+  auto start = std::chrono::steady_clock::now();
+  mgr_->start();
+  std::this_thread::sleep_for(std::chrono::milliseconds(500));
+  mgr_->stop();
+  mgr_->join();
+  std::chrono::duration<double> diff = std::chrono::steady_clock::now() - start;
+
+  uint64_t signals = 0;
+  for (auto* t : crowd) signals += t->signals();
+
+  std::cout << noise << " noise + " << momentum << " momentum traders, " << diff.count() << " s\n";
+  std::cout << "  trades: " << ob_->matchedTrades() << ", momentum orders: " << signals
+            << ", ticks: " << mgr_->ticks() << "\n";
+  EXPECT_GT(ob_->matchedTrades(), 0u);
+}
+
+TEST(SpscQueueTest, SpillsPastCapacityInOrder)
+{
+  SpscQueue<uint64_t> q(4);
+  std::vector<uint64_t> seen;
+  auto record = [&seen](uint64_t v) { seen.push_back(v); };
+
+  for (uint64_t i = 0; i < 10; ++i) q.push(i);  // 4 in the ring, 6 spilled
+  EXPECT_EQ(q.drain(record), 10u);
+  for (uint64_t i = 10; i < 13; ++i) q.push(i);  // back on the ring
+  EXPECT_EQ(q.drain(record), 3u);
+  EXPECT_EQ(q.drain(record), 0u);
+
+  ASSERT_EQ(seen.size(), 13u);
+  for (uint64_t i = 0; i < 13; ++i) EXPECT_EQ(seen[i], i);
+}
+
+TEST(SpscQueueTest, ConsumerSeesEveryPushInOrder)
+{
+  SpscQueue<uint64_t> q(64);
+  const uint64_t n = 200000;
+  std::thread producer([&q, n]() {
+    for (uint64_t i = 0; i < n; ++i) q.push(i);
+  });
+
+  uint64_t next = 0;
+  bool ordered = true;
+  while (next < n) {
+    q.drain([&](uint64_t v) { ordered &= v == next++; });
+  }
+  producer.join();
+  EXPECT_TRUE(ordered);
+  EXPECT_EQ(q.drain([](uint64_t) {}), 0u);
+}
+
+TEST(OwnerRegistryTest, GrowsWhileBeingRead)
+{
+  OwnerRegistry<int> reg(4);
+  std::vector<int> values(4096);
+  std::atomic<bool> done{false};
+
+  // reader hammers low ids that were registered before any growth
+  reg.set(1, &values[1]);
+  std::thread reader([&]() {
+    while (!done.load()) ASSERT_EQ(reg.find(1), &values[1]);
+  });
+
+  for (uint32_t i = 2; i < values.size(); ++i) reg.set(i, &values[i]);
+  done = true;
+  reader.join();
+
+  for (uint32_t i = 1; i < values.size(); ++i) EXPECT_EQ(reg.find(i), &values[i]);
+  EXPECT_EQ(reg.find(0), nullptr);
+  EXPECT_EQ(reg.find(100000), nullptr);
+}
+
+TEST(OrderIdAllocatorTest, SingleLeaseIsDenseAndOrdered)
+{
+  OrderIdAllocator ids(1, 8);
+  OrderIdAllocator::Lease lease;
+  for (OrderId expect = 1; expect <= 100; ++expect) EXPECT_EQ(ids.next(lease), expect);
+}
+
+TEST(OrderIdAllocatorTest, LeasesGetUniqueMonotonicIds)
+{
+  const int threads = 4;
+  const int perThread = 10000;
+  OrderIdAllocator ids(1, 64);
+  std::vector<std::vector<OrderId>> got(threads);
+
+  std::vector<std::thread> producers;
+  for (int t = 0; t < threads; ++t) {
+    producers.emplace_back([&, t]() {
+      OrderIdAllocator::Lease lease;
+      for (int i = 0; i < perThread; ++i) got[t].push_back(ids.next(lease));
+    });
+  }
+  for (auto& p : producers) p.join();
+
+  std::vector<OrderId> all;
+  for (auto& v : got) {
+    EXPECT_TRUE(std::is_sorted(v.begin(), v.end()));
+    all.insert(all.end(), v.begin(), v.end());
+  }
+  std::sort(all.begin(), all.end());
+  EXPECT_EQ(std::adjacent_find(all.begin(), all.end()), all.end());
+  // dense: at most one partially used block per lease
+  EXPECT_LE(all.back(), (OrderId)(threads * perThread + threads * 64));
+}
+
+TEST(OrderIdAllocatorTest, LeaseStaysMonotonicAcrossThreads)
+{
+  // a trader ticked by one worker, then stolen by another
+  OrderIdAllocator ids(1, 16);
+  OrderIdAllocator::Lease stolen, other;
+  std::vector<OrderId> got;
+  for (int round = 0; round < 4; ++round) {
+    std::thread([&]() {
+      ids.next(other);  // another trader on this worker
+      for (int i = 0; i < 5; ++i) got.push_back(ids.next(stolen));
+    }).join();
+  }
+  EXPECT_TRUE(std::is_sorted(got.begin(), got.end()));
+  EXPECT_EQ(std::adjacent_find(got.begin(), got.end()), got.end());
+}
+
+TEST(OrderIdAllocatorTest, AlternatingAllocatorsKeepTheirBlocks)
+{
+  OrderIdAllocator a(1, 16);
+  OrderIdAllocator b(1000, 16);
+  OrderIdAllocator::Lease la, lb;
+  for (OrderId i = 0; i < 16; ++i) {
+    EXPECT_EQ(a.next(la), 1 + i);
+    EXPECT_EQ(b.next(lb), 1000 + i);
+  }
+}
+
+TEST(OrderIdAllocatorTest, NewAllocatorRestartsLease)
+{
+  OrderIdAllocator::Lease lease;
+  {
+    OrderIdAllocator a(1, 16);
+    EXPECT_EQ(a.next(lease), 1u);
+  }
+  OrderIdAllocator b(1, 16);  // may reuse a's address
+  EXPECT_EQ(b.next(lease), 1u);
+}
+
+// --------------------------------------------------
+// Event-driven wake-ups
+// --------------------------------------------------
+
+// No timer: only ticks when the top of book moves
+class QuoteSubscriber : public Trader {
+ public:
+  QuoteSubscriber(uint32_t id, Orderbook &ob) : Trader(id, 100000, Strategy::Noise, ob) {
+    subscribe(WakeOnQuote);
+    setTimer(0);
+  }
+  void tick() override { ticks_.fetch_add(1); }
+  int ticks() const { return ticks_.load(); }
+ private:
+  std::atomic<int> ticks_{0};
+};
+
+// Rests one order on its only timer tick, then waits for the fill
+class FillSubscriber : public Trader {
+ public:
+  FillSubscriber(uint32_t id, Orderbook &ob) : Trader(id, 100000, Strategy::Noise, ob) {
+    subscribe(WakeOnFill);
+    setTimer(1000000);  // 1 s: the first tick is immediate, the next one would be too late
+  }
+  void tick() override {
+    if (!placed_) {
+      placeOrder(OrderType::GoodTillCancel, 100, 5, Side::Sell);
+      placed_ = true;
+      return;
+    }
+    fillTicks_.fetch_add(1);
+  }
+  int fillTicks() const { return fillTicks_.load(); }
+ private:
+  bool placed_{false};
+  std::atomic<int> fillTicks_{0};
+};
+
+TEST_F(TraderSimulationTest, EventDriven_QuoteSubscriberSleepsUntilQuoteChanges)
+{
+  auto sub = std::make_shared<QuoteSubscriber>(1, *ob_);
+  mgr_->addTrader(sub);
+  mgr_->start();
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(30));
+  EXPECT_EQ(sub->ticks(), 0);  // nothing happened, nothing ran
+
+  Order o(1, 99, OrderType::GoodTillCancel, 100, 1, Side::Buy);
+  OrderRequest r{RequestType::Add, o};
+  ob_->submitRequest(r);
+
+  int retries = 0;
+  while (sub->ticks() < 1 && ++retries < 200) std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  EXPECT_GE(sub->ticks(), 1);
+
+  // order below the best bid does not move the quote
+  int before = sub->ticks();
+  Order o2(2, 99, OrderType::GoodTillCancel, 90, 1, Side::Buy);
+  OrderRequest r2{RequestType::Add, o2};
+  ob_->submitRequest(r2);
+  WaitForSize(2);
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  EXPECT_EQ(sub->ticks(), before);
+
+  mgr_->stop();
+  mgr_->join();
+}
+
+TEST_F(TraderSimulationTest, EventDriven_FillWakesTrader)
+{
+  auto sub = std::make_shared<FillSubscriber>(2, *ob_);
+  mgr_->addTrader(sub);
+  mgr_->start();
+
+  WaitForSize(1);
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  EXPECT_EQ(sub->fillTicks(), 0);
+
+  Order buy(10, 99, OrderType::GoodTillCancel, 100, 5, Side::Buy);
+  OrderRequest r{RequestType::Add, buy};
+  ob_->submitRequest(r);
+
+  int retries = 0;
+  while (sub->fillTicks() < 1 && ++retries < 200) std::this_thread::sleep_for(std::chrono::milliseconds(5));
+
+  mgr_->stop();
+  mgr_->join();
+
+  EXPECT_EQ(sub->fillTicks(), 1);
+}
+
+// --------------------------------------------------
+// Parameter sweep
+// --------------------------------------------------
+
+TEST(SweepTest, SimulationIsDeterministic)
+{
+  SweepPoint p;
+  p.noiseTraders = 20;
+  p.seed = 7;
+  p.rounds = 2000;
+
+  SweepResult a = runSimulation(p);
+  SweepResult b = runSimulation(p);
+
+  EXPECT_GT(a.trades, 0u);
+  EXPECT_EQ(a.trades, b.trades);
+  EXPECT_EQ(a.volume, b.volume);
+  EXPECT_EQ(a.restingOrders, b.restingOrders);
+  EXPECT_DOUBLE_EQ(a.avgSpread, b.avgSpread);
+}
+
+TEST(SweepTest, ParallelSweepMatchesSerialRuns)
+{
+  SweepGrid grid;
+  grid.noiseTraders = {5, 15};
+  grid.priceSpread = {10, 40};
+  grid.seeds = {1, 2};
+  grid.rounds = 500;
+
+  std::vector<SweepPoint> points = expandGrid(grid);
+  ASSERT_EQ(points.size(), 8u);
+
+  std::vector<SweepResult> parallel = runSweep(points, 4);
+  ASSERT_EQ(parallel.size(), points.size());
+
+  for (size_t i = 0; i < points.size(); ++i) {
+    SweepResult serial = runSimulation(points[i]);
+    EXPECT_EQ(parallel[i].trades, serial.trades);
+    EXPECT_EQ(parallel[i].volume, serial.volume);
+    EXPECT_EQ(parallel[i].point.noiseTraders, points[i].noiseTraders);
+  }
+}
+
+// --------------------------------------------------
+// Coroutine traders
+// --------------------------------------------------
+
+// Waits for the first two-sided quote, then steps inside the spread
+class QuoteFollower : public CoTrader {
+ public:
+  QuoteFollower(uint32_t id, Orderbook &ob) : CoTrader(id, 100000, ob) {}
+
+  CoTask run() override {
+    Quote q{0, 0};
+    while (q.bid == 0 || q.ask == 0) q = co_await nextQuote();
+    seen_ = q;
+    placeOrder(OrderType::GoodTillCancel, q.bid + 1, 1, Side::Buy);
+    done_ = true;
+  }
+
+  Quote seen_{0, 0};
+  std::atomic<bool> done_{false};
+};
+
+// Crosses with itself to collect two fills, then rests and cancels an order
+class FillAndCancelAgent : public CoTrader {
+ public:
+  FillAndCancelAgent(uint32_t id, Orderbook &ob) : CoTrader(id, 100000, ob) {}
+
+  CoTask run() override {
+    placeOrder(OrderType::GoodTillCancel, 100, 5, Side::Sell);
+    placeOrder(OrderType::GoodTillCancel, 100, 5, Side::Buy);
+    Fill a = co_await nextFill();
+    Fill b = co_await nextFill();
+    filledQty_ = a.qty + b.qty;
+
+    OrderId id = placeOrder(OrderType::GoodTillCancel, 50, 1, Side::Buy);
+    co_await sleepFor(std::chrono::milliseconds(1));
+    cancelOrder(id);
+    ack_ = co_await cancelAck(id);
+    done_ = true;
+  }
+
+  Quantity filledQty_{0};
+  AckType ack_{AckType::Accepted};
+  std::atomic<bool> done_{false};
+};
+
+// Quote-driven agent for the scaling test: reacts to every book change
+class QuoteCounter : public CoTrader {
+ public:
+  QuoteCounter(uint32_t id, Orderbook &ob, std::atomic<uint64_t> &reactions)
+      : CoTrader(id, 100000, ob), reactions_(reactions) {}
+
+  CoTask run() override {
+    while (isRunning()) {
+      co_await nextQuote();
+      reactions_.fetch_add(1, std::memory_order_relaxed);
+    }
+  }
+
+ private:
+  std::atomic<uint64_t> &reactions_;
+};
+
+// Places one order (after the first quote change if `follow`) and records
+// the price of its first fill
+class FirstFillAgent : public CoTrader {
+ public:
+  FirstFillAgent(uint32_t id, Orderbook &ob, OrderType type, Price price, Side side, bool follow)
+      : CoTrader(id, 100000, ob), type_(type), price_(price), side_(side), follow_(follow) {}
+
+  CoTask run() override {
+    if (follow_) co_await nextQuote();
+    placeOrder(type_, price_, 5, side_);
+    Fill f = co_await nextFill();
+    fillPrice_ = f.price;
+    done_ = true;
+  }
+
+  OrderType type_;
+  Price price_;
+  Side side_;
+  bool follow_;
+  Price fillPrice_{0};
+  std::atomic<bool> done_{false};
+};
+
+TEST_F(TraderSimulationTest, CoTrader_BothSidesFillAtExecutionPrice)
+{
+  mgr_.reset();
+  CoScheduler sched(*ob_, 1);
+  // one worker resumes in spawn order: the seller is parked on nextQuote()
+  // before the bid it sells into is placed
+  auto seller = std::make_shared<FirstFillAgent>(2, *ob_, OrderType::FillAndKill, 90, Side::Sell, true);
+  auto buyer = std::make_shared<FirstFillAgent>(1, *ob_, OrderType::GoodTillCancel, 100, Side::Buy, false);
+  sched.spawn(seller);
+  sched.spawn(buyer);
+  sched.start();
+
+  int retries = 0;
+  while (!(seller->done_ && buyer->done_) && ++retries < 400)
+    std::this_thread::sleep_for(std::chrono::milliseconds(5));
+
+  sched.stop();
+  sched.join();
+
+  ASSERT_TRUE(seller->done_ && buyer->done_);
+  EXPECT_EQ(buyer->fillPrice_, 100);
+  EXPECT_EQ(seller->fillPrice_, 100);
+  EXPECT_EQ(buyer->cash(), 100000 - 500);
+  EXPECT_EQ(seller->cash(), 100000 + 500);
+}
+
+TEST_F(TraderSimulationTest, CoTrader_ReactsToQuote)
+{
+  mgr_.reset();  // the scheduler owns the book's listeners
+  CoScheduler sched(*ob_, 2);
+  auto agent = std::make_shared<QuoteFollower>(1, *ob_);
+  sched.spawn(agent);
+  sched.start();
+
+  // the agent must be parked on nextQuote() before the book moves
+  int warmup = 0;
+  while (sched.resumes() < 1 && ++warmup < 400) std::this_thread::sleep_for(std::chrono::milliseconds(5));
+
+  Order bid(1000, 99, OrderType::GoodTillCancel, 90, 1, Side::Buy);
+  Order ask(1001, 99, OrderType::GoodTillCancel, 110, 1, Side::Sell);
+  OrderRequest r1{RequestType::Add, bid};
+  OrderRequest r2{RequestType::Add, ask};
+  ob_->submitRequest(r1);
+  ob_->submitRequest(r2);
+
+  int retries = 0;
+  while (!agent->done_ && ++retries < 200) std::this_thread::sleep_for(std::chrono::milliseconds(5));
+  WaitForSize(3);
+
+  sched.stop();
+  sched.join();
+
+  EXPECT_EQ(agent->seen_.bid, 90);
+  EXPECT_EQ(agent->seen_.ask, 110);
+  EXPECT_EQ(ob_->topBidPrice(), 91);
+}
+
+TEST_F(TraderSimulationTest, CoTrader_FillsTimerAndCancelAck)
+{
+  mgr_.reset();
+  CoScheduler sched(*ob_, 1);
+  auto agent = std::make_shared<FillAndCancelAgent>(7, *ob_);
+  sched.spawn(agent);
+  sched.start();
+
+  int retries = 0;
+  while (!agent->done_ && ++retries < 400) std::this_thread::sleep_for(std::chrono::milliseconds(5));
+
+  sched.stop();
+  sched.join();
+
+  ASSERT_TRUE(agent->done_);
+  EXPECT_EQ(agent->filledQty_, 10u);
+  EXPECT_EQ(agent->ack_, AckType::Cancelled);
+  EXPECT_EQ(agent->stock(), 0);
+  EXPECT_EQ(ob_->size(), 0);
+}
+
+TEST_F(TraderSimulationTest, CoTrader_ManyAgentsOnFewThreads)
+{
+  mgr_.reset();
+  const int N = 20000;
+  std::atomic<uint64_t> reactions{0};
+
+  CoScheduler sched(*ob_, 2);
+  for (int i = 0; i < N; ++i) sched.spawn(std::make_shared<QuoteCounter>(i + 1, *ob_, reactions));
+  sched.start();
+
+  // let every agent reach its first nextQuote() before the book moves
+  int warmup = 0;
+  while (sched.resumes() < (uint64_t)N && ++warmup < 400) std::this_thread::sleep_for(std::chrono::milliseconds(5));
+
+  // every top-of-book change wakes the whole population once
+  for (int k = 0; k < 3; ++k) {
+    uint64_t target = (uint64_t)N * (k + 1);
+    Order o(5000 + k, 0, OrderType::GoodTillCancel, 100 + k, 1, Side::Buy);
+    OrderRequest r{RequestType::Add, o};
+    ob_->submitRequest(r);
+
+    int retries = 0;
+    while (reactions.load() < target && ++retries < 400) std::this_thread::sleep_for(std::chrono::milliseconds(5));
+    EXPECT_EQ(reactions.load(), target);
+  }
+
+  sched.stop();
+  sched.join();
+
+  // initial resume plus one per quote change: no polling in between
+  EXPECT_EQ(sched.resumes(), (uint64_t)N * 4);
+}